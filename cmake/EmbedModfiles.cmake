@@ -0,0 +1,36 @@
+# Generates the C++ source file OUTPUT that links the modfiles MODFILES (a list
+# of paths) into the executable. The modfiles are registered with
+# `LCompilers::register_embedded_modfiles()` during static initialization.
+#
+# Usage: cmake "-DMODFILES=a.mod;b.mod" -DOUTPUT=out.cpp -P EmbedModfiles.cmake
+
+set(arrays "")
+set(entries "")
+foreach(path ${MODFILES})
+    get_filename_component(name ${path} NAME_WE)
+    file(READ ${path} hex HEX)
+    string(LENGTH "${hex}" n)
+    math(EXPR size "${n} / 2")
+    # 16 bytes per line
+    string(REGEX REPLACE "(................................)" "\\1\n    " hex "${hex}")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+    # The loaded ASR points into the modfile, but never modifies it (the same
+    # as the read only mapping of a modfile on disk)
+    string(APPEND arrays "alignas(8) const unsigned char ${name}[] = {\n    ${bytes}\n};\n\n")
+    string(APPEND entries "    {\"${name}\", (const char*)${name}, ${size}},\n")
+endforeach()
+
+file(WRITE ${OUTPUT} "// Generated by cmake/EmbedModfiles.cmake, do not edit
+
+#include <libasr/modfile.h>
+
+namespace {
+
+${arrays}const LCompilers::EmbeddedModfile embedded_modfiles[] = {
+${entries}};
+
+const bool registered = LCompilers::register_embedded_modfiles(
+    embedded_modfiles, sizeof(embedded_modfiles) / sizeof(embedded_modfiles[0]));
+
+} // namespace
+")
@@ -0,0 +1,44 @@
+program loop_fusion_01
+! Fused array operations give the same results as separate ones
+implicit none
+integer, parameter :: n = 100
+real(8) :: a(n), b(n), c(n), d(n), e(n)
+integer :: i, j
+
+do i = 1, n
+    b(i) = i
+    c(i) = 2*i
+    e(i) = n - i
+end do
+
+! `a` is only used inside of the fused loop
+a = b + c
+d = a * e
+do i = 1, n
+    if (d(i) /= 3*i*(n - i)) error stop
+end do
+
+! The second loop reads an element the first one writes in a later iteration
+a = 2 * b
+d(2:n) = a(1:n-1)
+d(1) = 0
+do i = 1, n
+    if (d(i) /= 2*(i - 1)) error stop
+end do
+
+! Loops written by the user with different loop variables, `j` has its final
+! value after the loops
+j = 0
+do i = 1, n
+    a(i) = b(i) + 1
+end do
+do j = 1, n
+    d(j) = a(j) * 2
+end do
+if (j /= n + 1) error stop
+do i = 1, n
+    if (d(i) /= 2*(i + 1)) error stop
+end do
+
+print *, sum(d)
+end program
@@ -0,0 +1,73 @@
+program loop_tile_01
+! Tiled loop nests give the same results as untiled ones
+implicit none
+integer, parameter :: n = 70
+real(8) :: a(n, n), b(n, n), c(n, n), s
+integer :: i, j, k, m
+
+do j = 1, n
+    do i = 1, n
+        a(i, j) = i + 2*j
+        b(i, j) = i - j
+    end do
+end do
+
+! matmul
+c = 0
+do i = 1, n
+    do j = 1, n
+        do k = 1, n
+            c(i, j) = c(i, j) + a(i, k) * b(k, j)
+        end do
+    end do
+end do
+do j = 1, n
+    do i = 1, n
+        s = 0
+        do k = 1, n
+            s = s + a(i, k) * b(k, j)
+        end do
+        if (c(i, j) /= s) error stop
+    end do
+end do
+
+! transpose
+do i = 1, n
+    do j = 1, n
+        c(j, i) = a(i, j)
+    end do
+end do
+do j = 1, n
+    do i = 1, n
+        if (c(j, i) /= a(i, j)) error stop
+    end do
+end do
+
+! stencil
+c = 0
+do j = 2, n - 1
+    do i = 2, n - 1
+        c(i, j) = a(i - 1, j) + a(i + 1, j) + a(i, j - 1) + a(i, j + 1)
+    end do
+end do
+do j = 1, n
+    do i = 1, n
+        if (i == 1 .or. i == n .or. j == 1 .or. j == n) then
+            if (c(i, j) /= 0) error stop
+        else
+            if (c(i, j) /= 4*(i + 2*j)) error stop
+        end if
+    end do
+end do
+
+! zero-trip nest
+m = 0
+do i = 1, m
+    do j = 1, n
+        c(j, i) = -1
+    end do
+end do
+if (any(c == -1)) error stop
+
+print *, sum(c)
+end program
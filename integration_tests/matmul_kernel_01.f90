@@ -0,0 +1,100 @@
+program matmul_kernel_01
+! matmul and dot_product with the runtime kernels give the same results as
+! the naive loops
+implicit none
+! 37*41*29 multiplications, above the size that the kernels pack
+integer, parameter :: m = 37, k = 41, n = 29
+real(8) :: a(m, k), b(k, n), c(m, n), x(k), y(m), z(n), s
+real(4) :: a4(m, k), b4(k, n), c4(m, n)
+complex(4) :: ca4(m, k), cb4(k, n), cc4(m, n)
+complex(8) :: ca8(m, k), cb8(k, n), cc8(m, n)
+real(8), allocatable :: d(:, :)
+real(8) :: e(2*m, k)
+integer :: i, j
+
+! The elements are small integers, so the products are exact in any order
+do j = 1, k
+    do i = 1, m
+        a(i, j) = mod(i + 3*j, 7) - 3
+        e(2*i - 1, j) = a(i, j)
+        e(2*i, j) = 100
+    end do
+    x(j) = mod(j, 5) - 2
+end do
+do j = 1, n
+    do i = 1, k
+        b(i, j) = mod(2*i + j, 5) - 2
+    end do
+end do
+a4 = real(a, 4)
+b4 = real(b, 4)
+ca4 = cmplx(a, 1 - a, kind=4)
+cb4 = cmplx(b + 1, b, kind=4)
+ca8 = cmplx(a, 1 - a, kind=8)
+cb8 = cmplx(b + 1, b, kind=8)
+
+! odd shapes
+c = matmul(a, b)
+call check(a, b, c)
+c4 = matmul(a4, b4)
+call check(real(a4, 8), real(b4, 8), real(c4, 8))
+
+! matrix-vector and vector-matrix
+y = matmul(a, x)
+do i = 1, m
+    if (y(i) /= sum(a(i, :) * x)) error stop
+end do
+z = matmul(y, c)
+do j = 1, n
+    if (z(j) /= sum(y * c(:, j))) error stop
+end do
+
+! complex
+cc4 = matmul(ca4, cb4)
+cc8 = matmul(ca8, cb8)
+do j = 1, n
+    do i = 1, m
+        if (cc8(i, j) /= sum(ca8(i, :) * cb8(:, j))) error stop
+        if (cc4(i, j) /= cmplx(cc8(i, j), kind=4)) error stop
+    end do
+end do
+
+! allocatable target that is not allocated yet
+d = matmul(a, b)
+if (size(d, 1) /= m .or. size(d, 2) /= n) error stop
+if (any(d /= c)) error stop
+
+! strided assumed shape argument
+call matmul_assumed(e(1::2, :), b, c)
+call check(a, b, c)
+
+! dot_product
+s = dot_product(y, y)
+if (s /= sum(y * y)) error stop
+
+print *, sum(c), sum(z), s
+
+contains
+
+subroutine matmul_assumed(a, b, c)
+real(8), intent(in) :: a(:, :), b(:, :)
+real(8), intent(out) :: c(:, :)
+c = matmul(a, b)
+end subroutine
+
+subroutine check(a, b, c)
+real(8), intent(in) :: a(:, :), b(:, :), c(:, :)
+real(8) :: t
+integer :: i, j, p
+do j = 1, size(c, 2)
+    do i = 1, size(c, 1)
+        t = 0
+        do p = 1, size(a, 2)
+            t = t + a(i, p) * b(p, j)
+        end do
+        if (c(i, j) /= t) error stop
+    end do
+end do
+end subroutine
+
+end program
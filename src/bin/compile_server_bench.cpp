@@ -0,0 +1,85 @@
+// Compares the latency of compiling a small file with cold `lfortran`
+// invocations against requests sent to a running compile server.
+//
+// Usage: compile_server_bench [path/to/lfortran] [N]
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+bool server_ready(const std::string &socket_path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    socket_path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+    bool ok = connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0;
+    close(fd);
+    return ok;
+}
+
+double run(const std::string &cmd, int N) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < N; i++) {
+        if (std::system(cmd.c_str()) != 0) {
+            std::cerr << "Command failed: " << cmd << std::endl;
+            std::exit(1);
+        }
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count()
+        / 1000. / N;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string lfortran = argc > 1 ? argv[1] : "./lfortran";
+    int N = argc > 2 ? std::atoi(argv[2]) : 20;
+    std::string socket_path = "compile_server_bench.sock";
+    {
+        std::ofstream file;
+        file.open("compile_server_bench.f90");
+        file << R"(module compile_server_bench_mod
+use iso_fortran_env, only: dp => real64
+implicit none
+contains
+    real(dp) function f(x)
+    real(dp), intent(in) :: x
+    f = sin(x)**2 + sqrt(abs(x))
+    end function
+end module
+)";
+    }
+    std::string args = " -c compile_server_bench.f90 -o compile_server_bench.o";
+
+    std::cout << "Cold invocations" << std::endl;
+    double cold = run(lfortran + args, N);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl(lfortran.c_str(), lfortran.c_str(), "--compile-server",
+            socket_path.c_str(), (char*)nullptr);
+        std::cerr << "Cannot start the compile server" << std::endl;
+        _exit(1);
+    }
+    for (int i = 0; i < 500 && !server_ready(socket_path); i++) {
+        usleep(10000);
+    }
+    std::cout << "Compile server requests" << std::endl;
+    double warm = run(lfortran + " --connect " + socket_path + args, N);
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+
+    std::cout << "Files compiled: " << N << std::endl;
+    std::cout << "Cold latency per file:   " << cold << "ms" << std::endl;
+    std::cout << "Server latency per file: " << warm << "ms" << std::endl;
+    std::cout << "Speedup: " << cold / warm << "x" << std::endl;
+    return 0;
+}
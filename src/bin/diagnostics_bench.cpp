@@ -0,0 +1,79 @@
+// Benchmark of a warning heavy parse: every `.eq.`, `.gt.`, ... in free-form
+// code produces a style suggestion. The parse is timed with and without
+// recording the stacktrace of every diagnostic (`--show-stacktrace`).
+//
+// Usage: diagnostics_bench [file.f90]
+//
+// Without an argument, a file with 20k subroutines, each with several old
+// style relational operators, is generated.
+
+#include <iostream>
+#include <chrono>
+#include <lfortran/parser/parser.h>
+#include <libasr/diagnostics.h>
+#include <libasr/utils.h>
+
+// Best time in microseconds of `n_repeat` parses of `text`
+int64_t bench(const std::string &text, bool capture, int n_repeat,
+    size_t &n_diagnostics)
+{
+    LCompilers::diag::capture_stacktraces = capture;
+    int64_t best = -1;
+    for (int i = 0; i < n_repeat; i++) {
+        Allocator al(64*1024*1024);
+        LCompilers::diag::Diagnostics diagnostics;
+        LCompilers::CompilerOptions co;
+        auto t1 = std::chrono::high_resolution_clock::now();
+        auto result = LCompilers::LFortran::parse(al, text, diagnostics, co);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        if (!result.ok) {
+            std::cerr << "Parsing failed" << std::endl;
+            exit(1);
+        }
+        n_diagnostics = diagnostics.diagnostics.size();
+        int64_t t = std::chrono::duration_cast<std::chrono::microseconds>(
+            t2 - t1).count();
+        if (best < 0 || t < best) best = t;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string text;
+    if (argc > 1) {
+        if (!LCompilers::read_file(argv[1], text)) {
+            std::cerr << "Cannot read '" << argv[1] << "'" << std::endl;
+            return 1;
+        }
+    } else {
+        int N = 20000;
+        std::cout << "Construct" << std::endl;
+        for (int i = 0; i < N; i++) {
+            text.append("subroutine clip_" + std::to_string(i) + R"((x, lo, hi)
+real, intent(inout) :: x
+real, intent(in) :: lo, hi
+if (x .lt. lo) x = lo
+if (x .gt. hi) x = hi
+if (lo .eq. hi .or. x .ne. x) x = lo
+end subroutine
+
+)");
+        }
+    }
+
+    int n_repeat = 5;
+    size_t n_diagnostics;
+    std::cout << "Parse without stacktraces" << std::endl;
+    int64_t t_lazy = bench(text, false, n_repeat, n_diagnostics);
+    std::cout << "Time (best of " << n_repeat << "): " << t_lazy / 1000.
+        << "ms" << std::endl;
+    std::cout << "Number of diagnostics: " << n_diagnostics << std::endl;
+    std::cout << "Parse with stacktraces" << std::endl;
+    int64_t t_capture = bench(text, true, n_repeat, n_diagnostics);
+    std::cout << "Time (best of " << n_repeat << "): " << t_capture / 1000.
+        << "ms" << std::endl;
+    std::cout << "Speedup: "
+        << (t_lazy > 0 ? t_capture / (double)t_lazy : 0) << std::endl;
+    return 0;
+}
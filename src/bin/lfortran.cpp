@@ -4,12 +4,14 @@
 #include <stdlib.h>
 #include <filesystem>
 #include <random>
+#include <map>
 #ifndef CLI11_HAS_FILESYSTEM
 #define CLI11_HAS_FILESYSTEM 0
 #endif // CLI11_HAS_FILESYSTEM
 #include <bin/CLI11.hpp>
 
 #include <libasr/stacktrace.h>
+#include <libasr/trace.h>
 #include <lfortran/parser/parser.h>
 #include <lfortran/parser/preprocessor.h>
 #include <lfortran/pickle.h>
@@ -50,6 +52,8 @@
 #include <lfortran/fortran_kernel.h>
 #include <libasr/string_utils.h>
 #include <lfortran/utils.h>
+#include <lfortran/module_dependencies.h>
+#include <lfortran/compilation_cache.h>
 #include <lfortran/parser/parser.tab.hh>
 #include <string>
 #include <sstream>
@@ -60,6 +64,7 @@
 #include <bin/lfortran_accessor.h>
 #include <bin/lfortran_command_line_parser.h>
 #include <bin/lsp_cli.h>
+#include <bin/lfortran_compile_server.h>
 
 #ifdef WITH_LSP
 #include <bin/language_server_interface.h>
@@ -69,6 +74,12 @@
     #include <emscripten/emscripten.h>
 #endif
 
+#if !defined(_WIN32) && !defined(HAVE_BUILD_TO_WASM)
+    #define HAVE_LFORTRAN_FORK
+    #include <unistd.h>
+    #include <sys/wait.h>
+#endif
+
 // ANSI color codes
 #define RESET   "\033[0m"
 #define BLUE    "\033[34m"   // Blue for non-[PASS] entries
@@ -136,7 +147,8 @@ void print_one_component(std::string component) {
         std::cout << GREEN;
     } else if (component_name == "Allocator usage of last chunk (MB)") {
         std::cout << YELLOW;
-    } else if (component_name == "Allocator chunks") {
+    } else if (component_name == "Allocator chunks"
+            || component_name.find("Modfile read cache") == 0) {
         std::cout << CYAN;
     } else if (component_name == "File reading" || component_name == "Src -> ASR") {
         std::cout << MAGENTA;
@@ -166,12 +178,16 @@ void print_one_component(std::string component) {
 }
 
 
+// Entries that are not timings, they are printed before the table
+bool is_summary_entry(const std::string& entry) {
+    return entry.find("Allocator ") != std::string::npos ||
+        entry.find("Modfile read cache") != std::string::npos;
+}
+
 // Note: this function is case sensitive to the input string
 void print_time_report(const std::vector<std::string>& vector_of_time_report) {
     for (const auto& entry : vector_of_time_report) {
-        // check if `Allocator usage of last chunk (MB)` or `Allocator chunks` is present
-        if (entry.find("Allocator usage of last chunk (MB)") != std::string::npos ||
-            entry.find("Allocator chunks") != std::string::npos) {
+        if (is_summary_entry(entry)) {
             print_one_component(entry);
         }
     }
@@ -183,8 +199,7 @@ void print_time_report(const std::vector<std::string>& vector_of_time_report) {
     std::cout << std::string(60, '-') << '\n';
 
     for (const auto& entry : vector_of_time_report) {
-        if (entry.find("Allocator usage of last chunk (MB)") == std::string::npos &&
-            entry.find("Allocator chunks") == std::string::npos) {
+        if (!is_summary_entry(entry)) {
             print_one_component(entry);
         }
     }
@@ -192,6 +207,20 @@ void print_time_report(const std::vector<std::string>& vector_of_time_report) {
     std::cout << std::string(60, '-') << '\n';
 }
 
+// Prints the memory report to stdout (--memory-report) and writes it as
+// JSON (--memory-report-json)
+void print_memory_report(const CompilerOptions &compiler_options) {
+    const std::vector<LCompilers::MemoryUsage> &report
+        = compiler_options.po.vector_of_memory_report;
+    if (compiler_options.memory_report) {
+        std::cout << LCompilers::memory_report_to_text(report);
+    }
+    if (!compiler_options.memory_report_json.empty()) {
+        std::ofstream out(compiler_options.memory_report_json);
+        out << LCompilers::memory_report_to_json(report);
+    }
+}
+
 std::string read_file(const std::string &filename)
 {
     std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary
@@ -202,10 +231,10 @@ std::string read_file(const std::string &filename)
 
     ifs.seekg(0, std::ios::beg);
 
-    std::vector<char> bytes(filesize);
-    ifs.read(&bytes[0], filesize);
-
-    return std::string(&bytes[0], filesize);
+    // Read directly into the string, without an intermediate copy
+    std::string text(filesize, '\0');
+    ifs.read(&text[0], filesize);
+    return text;
 }
 
 #ifdef HAVE_LFORTRAN_LLVM
@@ -929,7 +958,8 @@ int dump_all_passes(const std::string &infile, CompilerOptions &compiler_options
 
 int save_mod_files(const LCompilers::ASR::TranslationUnit_t &u,
     const LCompilers::CompilerOptions &compiler_options,
-    LCompilers::LocationManager lm)
+    LCompilers::LocationManager lm,
+    std::vector<std::string> *mod_files=nullptr)
 {
     for (auto &item : u.m_symtab->get_scope()) {
         if (LCompilers::ASR::is_a<LCompilers::ASR::Module_t>(*item.second)) {
@@ -962,11 +992,8 @@ int save_mod_files(const LCompilers::ASR::TranslationUnit_t &u,
 
 	    std::filesystem::path filename { std::string(m->m_name) + ".mod" };
             std::filesystem::path fullpath = compiler_options.po.mod_files_dir / filename;
-            {
-                std::ofstream out;
-		out.open(fullpath, std::ofstream::out | std::ofstream::binary);
-                out << modfile_binary;
-            }
+            LCompilers::write_modfile(fullpath.string(), modfile_binary);
+            if (mod_files) mod_files->push_back(fullpath.string());
         }
     }
     return 0;
@@ -1094,12 +1121,51 @@ int compile_src_to_object_file(const std::string &infile,
     int time_llvm_to_bin=0;
 
     auto t1 = std::chrono::high_resolution_clock::now();
+    LCompilers::trace::set_file(infile);
+    LCompilers::trace::Scope trace_scope("Compile");
     std::string input = read_file(infile);
     auto t2 = std::chrono::high_resolution_clock::now();
     time_file_read = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
 
+    if (compiler_options.separate_compilation) {
+        compiler_options.po.intrinsic_symbols_mangling = true;
+    }
+
+    std::unique_ptr<LCompilers::LFortran::CompilationCache> cache;
+    std::string cache_key;
+    if (!compiler_options.cache_dir.empty()) {
+        cache = std::make_unique<LCompilers::LFortran::CompilationCache>(
+            compiler_options.cache_dir);
+        cache_key = cache->get_key(infile, input, compiler_options, lpm,
+            assembly);
+        std::string cached_diagnostics;
+        if (cache->restore(cache_key, outfile, compiler_options,
+                cached_diagnostics)) {
+            std::cerr << cached_diagnostics;
+            return 0;
+        }
+    }
+    // Rendered diagnostics, replayed on a cache hit
+    std::string rendered_diagnostics;
+    std::vector<std::string> mod_files;
+    std::vector<std::string> loaded_modules;
+
     LCompilers::FortranEvaluator fe(compiler_options);
     LCompilers::ASR::TranslationUnit_t* asr;
+    // The memory usage recorded while compiling `infile` is added to the
+    // report of all files on every return, also after an error
+    fe.compiler_options.po.vector_of_memory_report.clear();
+    struct MemoryReportMerger {
+        const std::string &infile;
+        std::vector<LCompilers::MemoryUsage> &from, &to;
+        ~MemoryReportMerger() {
+            for (auto &it : from) {
+                it.file = infile;
+                to.push_back(it);
+            }
+        }
+    } memory_report_merger{infile, fe.compiler_options.po.vector_of_memory_report,
+        compiler_options.po.vector_of_memory_report};
 
 
     // Src -> AST -> ASR
@@ -1111,31 +1177,39 @@ int compile_src_to_object_file(const std::string &infile,
         lm.files.push_back(fl);
         lm.file_ends.push_back(input.size());
     }
-    if (compiler_options.separate_compilation) {
-        compiler_options.po.intrinsic_symbols_mangling = true;
-    }
     LCompilers::diag::Diagnostics diagnostics;
     t1 = std::chrono::high_resolution_clock::now();
+    LCompilers::Result<LCompilers::LFortran::AST::TranslationUnit_t*>
+        ast = fe.get_ast2(input, lm, diagnostics);
+    // The AST does not reference the source, release it before semantics
+    std::string().swap(input);
     LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>
-        result = fe.get_asr2(input, lm, diagnostics);
+        result = ast.ok ? fe.get_asr3(*ast.result, diagnostics, lm)
+            : LCompilers::Result<LCompilers::ASR::TranslationUnit_t*>(ast.error);
     t2 = std::chrono::high_resolution_clock::now();
     time_src_to_asr = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
     bool has_error_w_cc = compiler_options.continue_compilation && diagnostics.has_error();
-    std::cerr << diagnostics.render(lm, compiler_options);
+    rendered_diagnostics = diagnostics.render(lm, compiler_options);
+    std::cerr << rendered_diagnostics;
     if (result.ok) {
         asr = result.result;
     } else {
         LCOMPILERS_ASSERT(diagnostics.has_error())
         return 1;
     }
+    if (cache) {
+        loaded_modules = LCompilers::LFortran::modules_loaded_from_modfiles(*asr);
+    }
 
     // Save .mod files
     {
         t1 = std::chrono::high_resolution_clock::now();
-        int err = save_mod_files(*asr, compiler_options, lm);
+        LCompilers::trace::Scope trace_scope("ASR -> mod");
+        int err = save_mod_files(*asr, compiler_options, lm, &mod_files);
         t2 = std::chrono::high_resolution_clock::now();
         time_save_mod = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
         if (err) return err;
+        LCompilers::record_memory_usage(fe.compiler_options.po, "ASR -> mod", fe.get_al());
     }
 
     // ASR -> LLVM
@@ -1146,6 +1220,10 @@ int compile_src_to_object_file(const std::string &infile,
         // Create an empty object file (things will be actually
         // compiled and linked when the main program is present):
         e.create_empty_object_file(outfile);
+        if (cache && !has_error_w_cc) {
+            cache->store(cache_key, outfile, mod_files, loaded_modules,
+                compiler_options, rendered_diagnostics);
+        }
         return 0;
     }
 
@@ -1166,7 +1244,11 @@ int compile_src_to_object_file(const std::string &infile,
     }
     LCompilers::Result<std::unique_ptr<LCompilers::LLVMModule>>
         res = fe.get_llvm3(*asr, lpm, diagnostics, infile);
-    std::cerr << diagnostics.render(lm, compiler_options);
+    {
+        std::string rendered = diagnostics.render(lm, compiler_options);
+        rendered_diagnostics += rendered;
+        std::cerr << rendered;
+    }
     if (res.ok) {
         m = std::move(res.result);
     } else {
@@ -1176,19 +1258,31 @@ int compile_src_to_object_file(const std::string &infile,
 
     if (compiler_options.po.fast) {
         t1 = std::chrono::high_resolution_clock::now();
+        LCompilers::trace::Scope trace_scope("LLVM opt");
         e.opt(*m->m_m);
         t2 = std::chrono::high_resolution_clock::now();
         time_opt = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+        LCompilers::record_memory_usage(fe.compiler_options.po, "LLVM opt", fe.get_al());
     }
 
     // LLVM -> Machine code (saves to an object file)
     if (assembly) {
+        LCompilers::trace::Scope trace_scope("LLVM -> ASM");
         e.save_asm_file(*(m->m_m), outfile);
+        LCompilers::record_memory_usage(fe.compiler_options.po, "LLVM -> ASM", fe.get_al());
     } else {
         t1 = std::chrono::high_resolution_clock::now();
+        LCompilers::trace::Scope trace_scope("LLVM -> BIN");
         e.save_object_file(*(m->m_m), outfile);
         t2 = std::chrono::high_resolution_clock::now();
         time_llvm_to_bin = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+        LCompilers::record_memory_usage(fe.compiler_options.po, "LLVM -> BIN", fe.get_al());
+    }
+
+    // GPU offloading writes an additional object file, which is not cached
+    if (cache && !has_error_w_cc && !compiler_options.po.enable_gpu_offloading) {
+        cache->store(cache_key, outfile, mod_files, loaded_modules,
+            compiler_options, rendered_diagnostics);
     }
 
     if(compiler_options.po.enable_gpu_offloading) {
@@ -1219,10 +1313,26 @@ int compile_src_to_object_file(const std::string &infile,
 
     if (time_report) {
         std::string message = "";
+        AllocatorStats al_stats = fe.get_al().stats();
         message = "Allocator usage of last chunk (MB): " +
             std::to_string(fe.get_al().size_current() / (1024. * 1024));
         compiler_options.po.vector_of_time_report.push_back(message);
-        message = "Allocator chunks: " + std::to_string(fe.get_al().num_chunks());
+        message = "Allocator allocated (MB): " +
+            std::to_string(al_stats.bytes_allocated / (1024. * 1024));
+        compiler_options.po.vector_of_time_report.push_back(message);
+        message = "Allocator reserved (MB): " +
+            std::to_string(al_stats.bytes_reserved / (1024. * 1024));
+        compiler_options.po.vector_of_time_report.push_back(message);
+        message = "Allocator alignment padding (MB): " +
+            std::to_string(al_stats.bytes_alignment / (1024. * 1024));
+        compiler_options.po.vector_of_time_report.push_back(message);
+        message = "Allocator chunks: " + std::to_string(al_stats.num_chunks);
+        compiler_options.po.vector_of_time_report.push_back(message);
+        LCompilers::ModfileReadCacheStats modfile_read_cache_stats
+            = LCompilers::get_modfile_read_cache_stats();
+        message = "Modfile read cache hits: " + std::to_string(modfile_read_cache_stats.hits);
+        compiler_options.po.vector_of_time_report.push_back(message);
+        message = "Modfile read cache misses: " + std::to_string(modfile_read_cache_stats.misses);
         compiler_options.po.vector_of_time_report.push_back(message);
         message = "File reading: " + std::to_string(time_file_read / 1000) + "." + std::to_string(time_file_read % 1000) + " ms";
         compiler_options.po.vector_of_time_report.push_back(message);
@@ -1263,6 +1373,106 @@ int compile_to_assembly_file(const std::string &infile,
 {
     return compile_src_to_object_file(infile, outfile, time_report, true, compiler_options, lpm);
 }
+
+/*
+ * Compiles `infiles[i]` to `outfiles[i]` using up to `jobs` worker processes.
+ * The `module` / `use` statements of each file are scanned first and a file
+ * is only started once all the files defining the modules it uses have
+ * finished (so their .mod files exist). Returns the exit code of each
+ * compilation; files that were not compiled because of an earlier error
+ * get the code 1.
+ */
+std::vector<int> compile_src_to_object_files_parallel(
+        const std::vector<std::string> &infiles,
+        const std::vector<std::string> &outfiles, int jobs,
+        CompilerOptions &compiler_options, LCompilers::PassManager& lpm)
+{
+    size_t n = infiles.size();
+    std::vector<LCompilers::LFortran::ModuleDependencies> deps;
+    for (auto &infile : infiles) {
+        deps.push_back(LCompilers::LFortran::scan_module_dependencies(
+            read_file(infile)));
+    }
+    std::vector<std::vector<size_t>> graph =
+        LCompilers::LFortran::module_dependency_graph(deps);
+    std::vector<size_t> n_pending_deps(n);
+    std::vector<std::vector<size_t>> dependents(n);
+    for (size_t i = 0; i < n; i++) {
+        n_pending_deps[i] = graph[i].size();
+        for (size_t dep : graph[i]) dependents[dep].push_back(i);
+    }
+
+    std::vector<int> status(n, 1);
+    std::vector<bool> started(n, false);
+    size_t n_started = 0;
+    bool failed = false;
+#ifdef HAVE_LFORTRAN_FORK
+    std::map<pid_t, size_t> running;
+#endif
+    auto finish = [&](size_t i, int err) {
+        status[i] = err;
+        if (err) failed = true;
+        for (size_t d : dependents[i]) n_pending_deps[d]--;
+    };
+    while (true) {
+        bool stop = failed && !compiler_options.continue_compilation;
+        // Files are started in the order given on the command line
+        size_t next = n;
+        for (size_t i = 0; i < n && !stop; i++) {
+            if (!started[i] && n_pending_deps[i] == 0) {
+                next = i;
+                break;
+            }
+        }
+#ifdef HAVE_LFORTRAN_FORK
+        if (running.size() > 0 && (next == n || running.size() >= (size_t)jobs)) {
+            int wstatus;
+            pid_t pid = waitpid(-1, &wstatus, 0);
+            if (pid < 0) break;
+            auto it = running.find(pid);
+            if (it != running.end()) {
+                finish(it->second, WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : 1);
+                running.erase(it);
+            }
+            continue;
+        }
+#endif
+        if (stop || n_started == n) break;
+        if (next == n) {
+            // Circular module dependency: compile the first remaining file,
+            // it will report the missing module
+            for (size_t i = 0; i < n; i++) {
+                if (!started[i]) {
+                    next = i;
+                    break;
+                }
+            }
+        }
+        started[next] = true;
+        n_started++;
+#ifdef HAVE_LFORTRAN_FORK
+        std::cout.flush();
+        std::cerr.flush();
+        pid_t pid = fork();
+        if (pid == 0) {
+            int err = compile_src_to_object_file(infiles[next], outfiles[next],
+                false, false, compiler_options, lpm);
+            std::cout.flush();
+            std::cerr.flush();
+            _exit(err);
+        } else if (pid > 0) {
+            running[pid] = next;
+            continue;
+        }
+        // fork() failed, compile in this process
+#else
+        (void)jobs;
+#endif
+        finish(next, compile_src_to_object_file(infiles[next], outfiles[next],
+            false, false, compiler_options, lpm));
+    }
+    return status;
+}
 #endif // HAVE_LFORTRAN_LLVM
 
 
@@ -2278,6 +2488,8 @@ EMSCRIPTEN_KEEPALIVE char* emit_wasm_from_source(char *input) {
 
 #endif
 
+int main_app_handle_exceptions(int argc, char *argv[]);
+
 int main_app(int argc, char *argv[]) {
     int dirname_length;
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -2336,6 +2548,17 @@ int main_app(int argc, char *argv[]) {
         return 0;
     }
     compiler_options.po.time_report = compiler_options.time_report;
+    compiler_options.po.memory_report = compiler_options.memory_report
+        || !compiler_options.memory_report_json.empty();
+    // Diagnostics only record where they were created if it will be shown
+    LCompilers::diag::capture_stacktraces = compiler_options.show_stacktrace;
+    if (!opts.arg_trace_out.empty()) {
+        if (!LCompilers::trace::open(opts.arg_trace_out)) {
+            std::cerr << "Cannot open the trace file '" << opts.arg_trace_out
+                << "'" << std::endl;
+            return 1;
+        }
+    }
 
     if (opts.print_targets) {
 #ifdef HAVE_LFORTRAN_LLVM
@@ -2347,6 +2570,17 @@ int main_app(int argc, char *argv[]) {
 #endif
     }
 
+    if (!opts.arg_compile_server.empty()) {
+        // State shared by all requests, inherited by the forked workers
+#ifdef HAVE_LFORTRAN_LLVM
+        LCompilers::LLVMEvaluator e(compiler_options.target);
+#endif
+        LCompilers::ASRUtils::preload_modfiles(
+            compiler_options.po.runtime_library_dir, "lfortran_intrinsic_");
+        return LCompilers::CompileServer::serve(opts.arg_compile_server,
+            main_app_handle_exceptions);
+    }
+
     if(opts.static_link && opts.shared_link) {
         std::cerr << "Options '--static' and '--shared' cannot be used together" << std::endl;
         return 1;
@@ -2558,7 +2792,9 @@ int main_app(int argc, char *argv[]) {
     if (opts.arg_S) {
         if (backend == Backend::llvm) {
 #ifdef HAVE_LFORTRAN_LLVM
-            return compile_to_assembly_file(opts.arg_file, outfile, compiler_options.time_report, compiler_options, lfortran_pass_manager);
+            int err = compile_to_assembly_file(opts.arg_file, outfile, compiler_options.time_report, compiler_options, lfortran_pass_manager);
+            print_memory_report(compiler_options);
+            return err;
 #else
             std::cerr << "The -S option requires the LLVM backend to be enabled. Recompile with `WITH_LLVM=yes`." << std::endl;
             return 1;
@@ -2573,8 +2809,10 @@ int main_app(int argc, char *argv[]) {
     if (opts.arg_c) {
         if (backend == Backend::llvm) {
 #ifdef HAVE_LFORTRAN_LLVM
-            return compile_src_to_object_file(opts.arg_file, outfile, compiler_options.time_report, false,
+            int err = compile_src_to_object_file(opts.arg_file, outfile, compiler_options.time_report, false,
                 compiler_options, lfortran_pass_manager);
+            print_memory_report(compiler_options);
+            return err;
 #else
             std::cerr << "The -c option requires the LLVM backend to be enabled. Recompile with `WITH_LLVM=yes`." << std::endl;
             return 1;
@@ -2605,6 +2843,28 @@ int main_app(int argc, char *argv[]) {
         }
     }
 
+    // Fortran files compiled ahead of the loop below by `-j N`
+    std::map<std::string, int> parallel_err;
+#ifdef HAVE_LFORTRAN_LLVM
+    if (opts.arg_jobs > 1 && backend == Backend::llvm) {
+        std::vector<std::string> infiles, outfiles;
+        for (const auto &arg_file : opts.arg_files) {
+            if ((endswith(arg_file, ".f90") || endswith(arg_file, ".f") ||
+                endswith(arg_file, ".F90") || endswith(arg_file, ".F"))
+                    && parallel_err.find(arg_file) == parallel_err.end()) {
+                infiles.push_back(arg_file);
+                outfiles.push_back(std::filesystem::path(arg_file).replace_extension(".tmp.o").string());
+                parallel_err[arg_file] = 1;
+            }
+        }
+        std::vector<int> errs = compile_src_to_object_files_parallel(infiles,
+            outfiles, opts.arg_jobs, compiler_options, lfortran_pass_manager);
+        for (size_t i = 0; i < infiles.size(); i++) {
+            parallel_err[infiles[i]] = errs[i];
+        }
+    }
+#endif
+
     int err_ = 0;
     std::vector<std::string> object_files;
     for (const auto &arg_file : opts.arg_files) {
@@ -2618,8 +2878,12 @@ int main_app(int argc, char *argv[]) {
             }
             if (backend == Backend::llvm) {
 #ifdef HAVE_LFORTRAN_LLVM
-                err = compile_src_to_object_file(arg_file, tmp_o, compiler_options.time_report, false,
-                    compiler_options, lfortran_pass_manager);
+                if (parallel_err.find(arg_file) != parallel_err.end()) {
+                    err = parallel_err[arg_file];
+                } else {
+                    err = compile_src_to_object_file(arg_file, tmp_o, compiler_options.time_report, false,
+                        compiler_options, lfortran_pass_manager);
+                }
 #else
                 std::cerr << "Compiling Fortran files to object files requires the LLVM backend to be enabled. Recompile with `WITH_LLVM=yes`." << std::endl;
                 return 1;
@@ -2678,17 +2942,14 @@ int main_app(int argc, char *argv[]) {
 
             print_time_report(compiler_options.po.vector_of_time_report);
         }
+        print_memory_report(compiler_options);
 
         return status_code;
     }
 }
 
-int main(int argc, char *argv[])
+int main_app_handle_exceptions(int argc, char *argv[])
 {
-    LCompilers::initialize();
-#if defined(HAVE_LFORTRAN_STACKTRACE)
-    LCompilers::print_stack_on_segfault();
-#endif
     try {
         return main_app(argc, argv);
     } catch(const LCompilers::LCompilersException &e) {
@@ -2711,3 +2972,27 @@ int main(int argc, char *argv[])
     }
     return 0;
 }
+
+int main(int argc, char *argv[])
+{
+    // A compile server client only forwards its arguments
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--connect" && i + 1 < argc) {
+            std::vector<char*> args(argv, argv + argc);
+            args.erase(args.begin() + i, args.begin() + i + 2);
+            return LCompilers::CompileServer::connect(argv[i+1],
+                args.size(), args.data());
+        } else if (LCompilers::startswith(arg, "--connect=")) {
+            std::vector<char*> args(argv, argv + argc);
+            args.erase(args.begin() + i);
+            return LCompilers::CompileServer::connect(arg.substr(10),
+                args.size(), args.data());
+        }
+    }
+    LCompilers::initialize();
+#if defined(HAVE_LFORTRAN_STACKTRACE)
+    LCompilers::print_stack_on_segfault();
+#endif
+    return main_app_handle_exceptions(argc, argv);
+}
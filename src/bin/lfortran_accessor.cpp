@@ -6,6 +6,7 @@
 #include <libasr/diagnostics.h>
 #include <libasr/exception.h>
 #include <libasr/location.h>
+#include <libasr/string_interner.h>
 
 #include <lfortran/ast_to_src.h>
 #include <lfortran/fortran_evaluator.h>
@@ -14,12 +15,23 @@
 
 namespace LCompilers::LLanguageServer {
 
+    namespace {
+        // Frees the identifiers interned by a request at its end: nothing of
+        // its AST is kept, and the requests are serialized by `mutex`
+        struct InternedStringsCleaner {
+            ~InternedStringsCleaner() {
+                LCompilers::clear_interned();
+            }
+        };
+    }
+
     auto LFortranAccessor::showErrors(
         const std::string &filename,
         const std::string &text,
         const CompilerOptions &compiler_options
     ) -> std::vector<LCompilers::error_highlight> {
         std::unique_lock<std::mutex> lock(mutex);
+        InternedStringsCleaner interned_strings_cleaner;
         LCompilers::FortranEvaluator fe(compiler_options);
 
         LCompilers::LocationManager lm;
@@ -75,6 +87,7 @@ namespace LCompilers::LLanguageServer {
         const CompilerOptions &compiler_options
     ) -> std::vector<LCompilers::document_symbols> {
         std::unique_lock<std::mutex> lock(mutex);
+        InternedStringsCleaner interned_strings_cleaner;
         LCompilers::FortranEvaluator fe(compiler_options);
         std::vector<LCompilers::document_symbols> symbol_lists;
 
@@ -133,6 +146,7 @@ namespace LCompilers::LLanguageServer {
         const CompilerOptions &compiler_options
     ) -> std::vector<std::pair<LCompilers::document_symbols, std::string>> {
         std::unique_lock<std::mutex> lock(mutex);
+        InternedStringsCleaner interned_strings_cleaner;
         LCompilers::FortranEvaluator fe(compiler_options);
         std::vector<std::pair<LCompilers::document_symbols, std::string>> symbol_lists;
 
@@ -196,6 +210,7 @@ namespace LCompilers::LLanguageServer {
         const CompilerOptions &compiler_options
     ) -> std::vector<LCompilers::document_symbols> {
         std::unique_lock<std::mutex> lock(mutex);
+        InternedStringsCleaner interned_strings_cleaner;
         LCompilers::FortranEvaluator fe(compiler_options);
         std::vector<LCompilers::document_symbols> symbol_lists;
 
@@ -239,6 +254,7 @@ namespace LCompilers::LLanguageServer {
         bool indent_unit
     ) -> LCompilers::Result<std::string> {
         std::unique_lock<std::mutex> lock(mutex);
+        InternedStringsCleaner interned_strings_cleaner;
         LCompilers::FortranEvaluator fe(compiler_options);
         LCompilers::LocationManager lm;
         LCompilers::diag::Diagnostics diagnostics;
@@ -270,6 +286,7 @@ namespace LCompilers::LLanguageServer {
         const CompilerOptions &compiler_options
     ) -> std::vector<LCompilers::document_symbols> {
         std::unique_lock<std::mutex> lock(mutex);
+        InternedStringsCleaner interned_strings_cleaner;
         LCompilers::FortranEvaluator fe(compiler_options);
         std::vector<LCompilers::document_symbols> symbol_lists;
 
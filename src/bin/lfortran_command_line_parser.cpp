@@ -52,6 +52,13 @@ namespace LCompilers::CommandLineInterface {
         app.add_option("-O", opts.O_flags, "Optimization level (ignored for now)")->allow_extra_args(false);
 
         // LFortran specific options
+        app.add_option("-j,--jobs", opts.arg_jobs, "Compile up to N source files in parallel, respecting module dependencies")->capture_default_str();
+        app.add_option("--parse-threads", compiler_options.parse_threads, "Parse the top-level program units of a large free-form source file on N threads")->capture_default_str();
+        app.add_option("--pass-threads", compiler_options.po.pass_threads, "Apply the ASR passes that transform one procedure at a time on N threads")->capture_default_str();
+        app.add_option("--cache-dir", compiler_options.cache_dir, "Cache object and mod files of compiled sources in the given directory");
+        app.add_option("--compile-server", opts.arg_compile_server, "Run a compile server listening on the given Unix socket");
+        app.add_option("--connect", opts.arg_connect, "Send the compilation to the compile server listening on the given Unix socket");
+        app.add_flag("--lazy-modfiles", compiler_options.po.lazy_modfiles, "Only load the symbols of used modules that are referenced");
         app.add_flag("--cpp", opts.cpp, "Enable C preprocessing");
         app.add_flag("--cpp-infer", opts.cpp_infer, "Use heuristics to infer if a file needs preprocessing");
         app.add_flag("--no-cpp", opts.no_cpp, "Disable C preprocessing");
@@ -85,6 +92,9 @@ namespace LCompilers::CommandLineInterface {
         app.add_flag("--show-stacktrace", compiler_options.show_stacktrace, "Show internal stacktrace on compiler errors");
         app.add_flag("--symtab-only", compiler_options.symtab_only, "Only create symbol tables in ASR (skip executable stmt)");
         app.add_flag("--time-report", compiler_options.time_report, "Show compilation time report");
+        app.add_flag("--memory-report", compiler_options.memory_report, "Show peak memory and allocator usage after each compilation phase");
+        app.add_option("--memory-report-json", compiler_options.memory_report_json, "Write the memory report as JSON to the given file");
+        app.add_option("--trace-out", opts.arg_trace_out, "Write a Chrome trace (chrome://tracing, Perfetto) of the compiler phases and passes to the given file");
         app.add_flag("--static", opts.static_link, "Create a static executable");
         app.add_flag("--shared", opts.shared_link, "Create a shared executable");
         app.add_flag("--logical-casting", compiler_options.logical_casting, "Allow logical casting");
@@ -106,6 +116,8 @@ namespace LCompilers::CommandLineInterface {
         app.add_flag("--rtlib", compiler_options.rtlib, "Include the full runtime library in the LLVM output");
         app.add_flag("--use-loop-variable-after-loop", compiler_options.po.use_loop_variable_after_loop, "Allow using loop variable after the loop");
         app.add_flag("--fast", compiler_options.po.fast, "Best performance (disable strict standard compliance)");
+        app.add_option("--tile-cache-size", compiler_options.po.tile_cache_size, "Cache size in bytes that the loop nests tiled with --fast are blocked for")->capture_default_str();
+        app.add_option("--blas", compiler_options.po.blas, "Link with the BLAS library <lib> (-l<lib>) and call its cblas_?gemm for large real matmul products with --fast");
         app.add_flag("--linker", opts.linker, "Specify the linker to be used, available options: clang or gcc")->capture_default_str();
         app.add_flag("--linker-path", opts.linker_path, "Use the linker from this path")->capture_default_str();
         app.add_option("--target", compiler_options.target, "Generate code for the given target")->capture_default_str();
@@ -215,6 +227,9 @@ namespace LCompilers::CommandLineInterface {
         compiler_options.prescan = !opts.arg_no_prescan;
         // set openmp in pass options
         compiler_options.po.openmp = compiler_options.openmp;
+        if (!compiler_options.po.blas.empty()) {
+            opts.arg_l.push_back(compiler_options.po.blas);
+        }
 
         for (auto &f_flag : opts.f_flags) {
             if (f_flag == "PIC") {
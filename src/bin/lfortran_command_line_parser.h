@@ -24,6 +24,10 @@ namespace LCompilers::CommandLineInterface {
         bool arg_c = false;
         bool arg_v = false;
         bool arg_E = false;
+        int arg_jobs = 1;
+        std::string arg_compile_server;
+        std::string arg_connect;
+        std::string arg_trace_out;
         std::vector<std::string> arg_l;
         std::vector<std::string> arg_L;
         std::vector<std::string> arg_files;
@@ -0,0 +1,279 @@
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#if !defined(_WIN32) && !defined(HAVE_BUILD_TO_WASM)
+#define HAVE_LFORTRAN_COMPILE_SERVER
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <bin/lfortran_compile_server.h>
+
+namespace LCompilers::CompileServer {
+
+#ifdef HAVE_LFORTRAN_COMPILE_SERVER
+
+namespace {
+
+volatile sig_atomic_t stop_requested = 0;
+
+void handle_stop(int /* signal */) {
+    stop_requested = 1;
+}
+
+void handle_child(int /* signal */) {
+    int saved_errno = errno;
+    while (waitpid(-1, nullptr, WNOHANG) > 0) {}
+    errno = saved_errno;
+}
+
+bool read_all(int fd, void *data, size_t size) {
+    char *p = (char*)data;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool write_all(int fd, const void *data, size_t size) {
+    const char *p = (const char*)data;
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool make_address(const std::string &socket_path, sockaddr_un &addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "The compile server socket path '" << socket_path
+            << "' is too long" << std::endl;
+        return false;
+    }
+    std::strcpy(addr.sun_path, socket_path.c_str());
+    return true;
+}
+
+/*
+ * Request format: a 4 byte payload size sent together with the client's
+ * stdin, stdout and stderr (SCM_RIGHTS), followed by the payload: the current
+ * directory and the command line arguments, each terminated by '\0'.
+ * Response: the 4 byte exit code.
+ */
+const size_t n_request_fds = 3;
+
+bool receive_request(int conn, std::vector<int> &fds, std::string &payload) {
+    uint32_t size;
+    char control[CMSG_SPACE(n_request_fds * sizeof(int))];
+    iovec iov;
+    iov.iov_base = &size;
+    iov.iov_len = sizeof(size);
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t n;
+    do {
+        n = recvmsg(conn, &msg, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n != sizeof(size)) return false;
+    for (cmsghdr *c = CMSG_FIRSTHDR(&msg); c != nullptr; c = CMSG_NXTHDR(&msg, c)) {
+        if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+            size_t n_fds = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            fds.resize(n_fds);
+            std::memcpy(fds.data(), CMSG_DATA(c), n_fds * sizeof(int));
+        }
+    }
+    payload.resize(size);
+    return size == 0 || read_all(conn, &payload[0], size);
+}
+
+// Serves the request on the connection `conn` of the listening socket
+// `server` in a child process
+void serve_request(int server, int conn,
+        const std::function<int(int, char**)> &compile) {
+    std::vector<int> fds;
+    std::string payload;
+    if (!receive_request(conn, fds, payload) || fds.size() != n_request_fds) {
+        for (int fd : fds) close(fd);
+        return;
+    }
+    std::vector<std::string> args;
+    size_t start = 0;
+    while (start < payload.size()) {
+        size_t end = payload.find('\0', start);
+        if (end == std::string::npos) end = payload.size();
+        args.push_back(payload.substr(start, end - start));
+        start = end + 1;
+    }
+    if (args.empty()) {
+        for (int fd : fds) close(fd);
+        return;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // The listening socket is released as soon as the server stops, even
+        // if this compilation is still running
+        close(server);
+        signal(SIGCHLD, SIG_DFL);
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        for (size_t i = 0; i < n_request_fds; i++) {
+            dup2(fds[i], i);
+            close(fds[i]);
+        }
+        int code = 1;
+        if (chdir(args[0].c_str()) != 0) {
+            std::cerr << "Compile server: cannot change directory to '"
+                << args[0] << "'" << std::endl;
+        } else {
+            // args[0] is the client's directory, replace it by the program name
+            args[0] = "lfortran";
+            std::vector<char*> argv;
+            for (auto &arg : args) argv.push_back(&arg[0]);
+            argv.push_back(nullptr);
+            code = compile(argv.size() - 1, argv.data());
+            std::cout.flush();
+            std::cerr.flush();
+        }
+        int32_t response = code;
+        write_all(conn, &response, sizeof(response));
+        _exit(code);
+    }
+    for (int fd : fds) close(fd);
+}
+
+} // namespace
+
+int serve(const std::string &socket_path,
+    const std::function<int(int, char**)> &compile)
+{
+    sockaddr_un addr;
+    if (!make_address(socket_path, addr)) return 1;
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        std::cerr << "Cannot create the compile server socket: "
+            << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    unlink(socket_path.c_str());
+    if (bind(server, (sockaddr*)&addr, sizeof(addr)) < 0
+            || listen(server, 64) < 0) {
+        std::cerr << "Cannot listen on '" << socket_path << "': "
+            << std::strerror(errno) << std::endl;
+        close(server);
+        return 1;
+    }
+
+    struct sigaction sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    // No SA_RESTART, so that `accept` returns when asked to stop
+    sa.sa_handler = handle_stop;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    sa.sa_handler = handle_child;
+    sa.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigaction(SIGCHLD, &sa, nullptr);
+
+    while (!stop_requested) {
+        int conn = accept(server, nullptr, nullptr);
+        if (conn < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Compile server: accept failed: "
+                << std::strerror(errno) << std::endl;
+            break;
+        }
+        serve_request(server, conn, compile);
+        close(conn);
+    }
+    close(server);
+    unlink(socket_path.c_str());
+    return 0;
+}
+
+int connect(const std::string &socket_path, int argc, char *argv[]) {
+    sockaddr_un addr;
+    if (!make_address(socket_path, addr)) return 1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        std::cerr << "Cannot connect to the compile server at '"
+            << socket_path << "': " << std::strerror(errno) << std::endl;
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+
+    std::string payload = std::filesystem::current_path().string();
+    payload.push_back('\0');
+    for (int i = 1; i < argc; i++) {
+        payload += argv[i];
+        payload.push_back('\0');
+    }
+    uint32_t size = payload.size();
+
+    int fds[n_request_fds] = {0, 1, 2};
+    char control[CMSG_SPACE(sizeof(fds))];
+    std::memset(control, 0, sizeof(control));
+    iovec iov;
+    iov.iov_base = &size;
+    iov.iov_len = sizeof(size);
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(fds));
+    std::memcpy(CMSG_DATA(c), fds, sizeof(fds));
+
+    int32_t code;
+    if (sendmsg(fd, &msg, 0) != sizeof(size)
+            || !write_all(fd, payload.data(), payload.size())
+            || !read_all(fd, &code, sizeof(code))) {
+        std::cerr << "The compile server at '" << socket_path
+            << "' did not complete the request" << std::endl;
+        close(fd);
+        return 1;
+    }
+    close(fd);
+    return code;
+}
+
+#else
+
+int serve(const std::string &/*socket_path*/,
+    const std::function<int(int, char**)> &/*compile*/)
+{
+    std::cerr << "The compile server is not supported on this platform" << std::endl;
+    return 1;
+}
+
+int connect(const std::string &/*socket_path*/, int /*argc*/, char *[] /*argv*/) {
+    std::cerr << "The compile server is not supported on this platform" << std::endl;
+    return 1;
+}
+
+#endif // HAVE_LFORTRAN_COMPILE_SERVER
+
+} // namespace LCompilers::CompileServer
@@ -0,0 +1,33 @@
+#ifndef LFORTRAN_COMPILE_SERVER_H
+#define LFORTRAN_COMPILE_SERVER_H
+
+#include <functional>
+#include <string>
+
+namespace LCompilers::CompileServer {
+
+/*
+ * A compile server keeps the expensive, request independent state of the
+ * compiler (initialized LLVM targets, intrinsic modfiles) warm in a long
+ * running process and serves compile requests from thin clients over a local
+ * Unix socket.
+ *
+ * The client sends its current directory, its command line arguments and its
+ * stdin / stdout / stderr file descriptors. The server forks a worker for each
+ * request, so every compilation starts from the same warm state and runs
+ * exactly as a cold `lfortran` invocation would (including its output), and
+ * the exit code is sent back to the client.
+ */
+
+// Listens on `socket_path` and runs `compile(argc, argv)` in a forked worker
+// for every request. Returns when the server receives SIGINT or SIGTERM.
+int serve(const std::string &socket_path,
+    const std::function<int(int, char**)> &compile);
+
+// Sends the arguments `argv[1..argc-1]` to the server listening on
+// `socket_path` and returns the exit code of the compilation.
+int connect(const std::string &socket_path, int argc, char *argv[]);
+
+} // namespace LCompilers::CompileServer
+
+#endif // LFORTRAN_COMPILE_SERVER_H
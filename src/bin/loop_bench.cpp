@@ -0,0 +1,182 @@
+// Benchmark of the `loop_tile` pass on a matrix multiply, a transpose, a 3D
+// stencil and an elementwise sum. Their loops are written in the cache
+// unfriendly order (the first index in the outermost loop). The pass tiles
+// the first two and only interchanges the loops of the others, whose
+// elements are not reused. Each kernel is compiled with --fast, without and
+// with the pass, and run with the LLVM JIT.
+//
+// Usage: loop_bench [n_matmul [n_transpose [n_stencil [n_elementwise]]]]
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <lfortran/fortran_evaluator.h>
+#include <lfortran/utils.h>
+#include <libasr/pass/pass_manager.h>
+
+using LCompilers::FortranEvaluator;
+
+std::string kernels = R"(
+subroutine bench_matmul(n, s)
+integer, intent(in) :: n
+real(8), intent(out) :: s
+real(8), allocatable :: a(:,:), b(:,:), c(:,:)
+integer :: i, j, k
+allocate(a(n,n), b(n,n), c(n,n))
+do j = 1, n
+    do i = 1, n
+        a(i,j) = i + 2*j
+        b(i,j) = i - j
+        c(i,j) = 0
+    end do
+end do
+do i = 1, n
+    do j = 1, n
+        do k = 1, n
+            c(i,j) = c(i,j) + a(i,k) * b(k,j)
+        end do
+    end do
+end do
+s = sum(c)
+end subroutine
+
+subroutine bench_transpose(n, s)
+integer, intent(in) :: n
+real(8), intent(out) :: s
+real(8), allocatable :: a(:,:), b(:,:)
+integer :: i, j
+allocate(a(n,n), b(n,n))
+do j = 1, n
+    do i = 1, n
+        a(i,j) = i + n*j
+    end do
+end do
+do i = 1, n
+    do j = 1, n
+        b(j,i) = a(i,j)
+    end do
+end do
+s = b(1,n) + b(n,1)
+end subroutine
+
+subroutine bench_stencil(n, s)
+integer, intent(in) :: n
+real(8), intent(out) :: s
+real(8), allocatable :: u(:,:,:), v(:,:,:)
+integer :: i, j, k
+allocate(u(n,n,n), v(n,n,n))
+do k = 1, n
+    do j = 1, n
+        do i = 1, n
+            u(i,j,k) = i + j + k
+            v(i,j,k) = 0
+        end do
+    end do
+end do
+do i = 2, n-1
+    do j = 2, n-1
+        do k = 2, n-1
+            v(i,j,k) = (u(i-1,j,k) + u(i+1,j,k) + u(i,j-1,k) &
+                + u(i,j+1,k) + u(i,j,k-1) + u(i,j,k+1)) / 6
+        end do
+    end do
+end do
+s = v(2,2,2) + v(n-1,n-1,n-1)
+end subroutine
+
+subroutine bench_elementwise(n, s)
+integer, intent(in) :: n
+real(8), intent(out) :: s
+real(8), allocatable :: a(:,:), b(:,:), c(:,:)
+integer :: i, j
+allocate(a(n,n), b(n,n), c(n,n))
+do j = 1, n
+    do i = 1, n
+        a(i,j) = i + n*j
+        b(i,j) = i - j
+    end do
+end do
+do i = 1, n
+    do j = 1, n
+        c(i,j) = a(i,j) + 2*b(i,j)
+    end do
+end do
+s = c(1,n) + c(n,1)
+end subroutine
+)";
+
+struct Run {
+    int64_t us;
+    double checksum;
+};
+
+// Best time in microseconds of `n_repeat` calls of the kernel `name`
+Run bench(const std::string &name, int n, bool tile, int n_repeat)
+{
+    LCompilers::CompilerOptions co;
+    co.interactive = true;
+    co.po.fast = true;
+    co.po.runtime_library_dir = LCompilers::LFortran::get_runtime_library_dir();
+    FortranEvaluator e(co);
+    LCompilers::LocationManager lm;
+    {
+        LCompilers::LocationManager::FileLocations fl;
+        fl.in_filename = "input.f90";
+        lm.files.push_back(fl);
+    }
+    LCompilers::PassManager lpm;
+    lpm.use_default_passes();
+    std::string passes = "", skip_passes = tile ? "" : "loop_tile";
+    lpm.parse_pass_arg(passes, skip_passes);
+    auto eval = [&](const std::string &code) {
+        LCompilers::diag::Diagnostics diagnostics;
+        LCompilers::Result<FortranEvaluator::EvalResult> r
+            = e.evaluate(code, false, lm, lpm, diagnostics);
+        if (!r.ok) {
+            std::cerr << diagnostics.render(lm, co) << std::endl;
+            exit(1);
+        }
+        return r.result;
+    };
+    eval(kernels);
+    eval("real(8) :: s");
+    Run best = {-1, 0};
+    for (int i = 0; i < n_repeat; i++) {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        eval("call " + name + "(" + std::to_string(n) + ", s)");
+        auto t2 = std::chrono::high_resolution_clock::now();
+        int64_t t = std::chrono::duration_cast<std::chrono::microseconds>(
+            t2 - t1).count();
+        if (best.us < 0 || t < best.us) best.us = t;
+    }
+    best.checksum = eval("s").f64;
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    int n[4] = {512, 4096, 256, 4096};
+    for (int i = 1; i < argc && i <= 4; i++) {
+        n[i - 1] = std::stoi(argv[i]);
+    }
+    std::string names[4] = {"bench_matmul", "bench_transpose", "bench_stencil",
+        "bench_elementwise"};
+    std::cout << std::setw(18) << "kernel" << std::setw(7) << "n"
+        << std::setw(14) << "untiled [ms]" << std::setw(12) << "tiled [ms]"
+        << std::setw(10) << "speedup" << std::endl;
+    for (int i = 0; i < 4; i++) {
+        Run untiled = bench(names[i], n[i], false, 3);
+        Run tiled = bench(names[i], n[i], true, 3);
+        std::cout << std::setw(18) << names[i] << std::setw(7) << n[i]
+            << std::setw(14) << untiled.us / 1000
+            << std::setw(12) << tiled.us / 1000
+            << std::setw(9) << std::fixed << std::setprecision(2)
+            << (double) untiled.us / tiled.us << "x";
+        if (untiled.checksum != tiled.checksum) {
+            std::cout << "  (results differ: " << untiled.checksum << " vs "
+                << tiled.checksum << ")";
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
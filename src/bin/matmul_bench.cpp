@@ -0,0 +1,124 @@
+// Benchmark of `c = matmul(a, b)` for square real(8) matrices from 4 x 4 to
+// 4096 x 4096, computed by the loops of the `intrinsic_function` pass (the
+// `matmul_kernel` pass skipped) and by the runtime library kernel. The
+// programs are run with the LLVM JIT, so --blas cannot be used here.
+//
+// Usage: matmul_bench [max_n [max_loops_n]]
+//
+// Sizes above `max_loops_n` (default 1024) are not timed with the loops.
+
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include <lfortran/fortran_evaluator.h>
+#include <lfortran/utils.h>
+#include <libasr/pass/pass_manager.h>
+
+using LCompilers::FortranEvaluator;
+
+std::string kernel = R"(
+subroutine bench_matmul(n, r, s)
+integer, intent(in) :: n, r
+real(8), intent(out) :: s
+real(8), allocatable :: a(:,:), b(:,:), c(:,:)
+integer :: i, j, l
+allocate(a(n,n), b(n,n), c(n,n))
+do j = 1, n
+    do i = 1, n
+        a(i,j) = modulo(i + 2*j, 7) - 3
+        b(i,j) = modulo(i - j, 5) - 2
+    end do
+end do
+do l = 1, r
+    c = matmul(a, b)
+end do
+s = sum(c)
+end subroutine
+)";
+
+struct Run {
+    int64_t us;
+    double checksum;
+};
+
+// Best time in microseconds of `n_repeat` calls of `bench_matmul(n, r, s)`
+Run bench(int n, int64_t r, bool use_kernel, int n_repeat)
+{
+    LCompilers::CompilerOptions co;
+    co.interactive = true;
+    co.po.fast = true;
+    co.po.runtime_library_dir = LCompilers::LFortran::get_runtime_library_dir();
+    FortranEvaluator e(co);
+    LCompilers::LocationManager lm;
+    {
+        LCompilers::LocationManager::FileLocations fl;
+        fl.in_filename = "input.f90";
+        lm.files.push_back(fl);
+    }
+    LCompilers::PassManager lpm;
+    lpm.use_default_passes();
+    std::string passes = "", skip_passes = use_kernel ? "" : "matmul_kernel";
+    lpm.parse_pass_arg(passes, skip_passes);
+    auto eval = [&](const std::string &code) {
+        LCompilers::diag::Diagnostics diagnostics;
+        LCompilers::Result<FortranEvaluator::EvalResult> res
+            = e.evaluate(code, false, lm, lpm, diagnostics);
+        if (!res.ok) {
+            std::cerr << diagnostics.render(lm, co) << std::endl;
+            exit(1);
+        }
+        return res.result;
+    };
+    eval(kernel);
+    eval("real(8) :: s");
+    Run best = {-1, 0};
+    for (int i = 0; i < n_repeat; i++) {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        eval("call bench_matmul(" + std::to_string(n) + ", "
+            + std::to_string(r) + ", s)");
+        auto t2 = std::chrono::high_resolution_clock::now();
+        int64_t t = std::chrono::duration_cast<std::chrono::microseconds>(
+            t2 - t1).count();
+        if (best.us < 0 || t < best.us) best.us = t;
+    }
+    best.checksum = eval("s").f64;
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    int max_n = 4096, max_loops_n = 1024;
+    if (argc > 1) max_n = std::stoi(argv[1]);
+    if (argc > 2) max_loops_n = std::stoi(argv[2]);
+    std::cout << std::setw(6) << "n" << std::setw(10) << "repeats"
+        << std::setw(12) << "loops [ms]" << std::setw(13) << "kernel [ms]"
+        << std::setw(10) << "speedup" << std::setw(10) << "GFLOP/s"
+        << std::endl;
+    for (int n = 4; n <= max_n; n *= 4) {
+        // About 2^28 multiplications per measurement
+        int64_t r = std::max<int64_t>(1, (int64_t(1) << 28) / n / n / n);
+        Run kernel_run = bench(n, r, true, 3);
+        double gflops = 2.0 * n * n * n * r / kernel_run.us / 1000;
+        std::cout << std::setw(6) << n << std::setw(10) << r;
+        std::string note;
+        if (n <= max_loops_n) {
+            Run loops_run = bench(n, r, false, 3);
+            std::cout << std::setw(12) << loops_run.us / 1000
+                << std::setw(13) << kernel_run.us / 1000
+                << std::setw(9) << std::fixed << std::setprecision(2)
+                << (double) loops_run.us / kernel_run.us << "x";
+            if (loops_run.checksum != kernel_run.checksum) {
+                note = "  (results differ: "
+                    + std::to_string(loops_run.checksum) + " vs "
+                    + std::to_string(kernel_run.checksum) + ")";
+            }
+        } else {
+            std::cout << std::setw(12) << "-" << std::setw(13)
+                << kernel_run.us / 1000 << std::setw(10) << "-";
+        }
+        std::cout << std::setw(10) << std::fixed << std::setprecision(2)
+            << gflops << note << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+// Benchmark of the fixed-form (F77) prescanner, tokenizer and parser,
+// compared to the free-form path on the same code
+//
+// Usage: parse_fixed [file.f]
+//
+// Without an argument, a file with labeled DO loops, column 6 continuation
+// lines, COMMON blocks and FORMAT statements is generated, together with its
+// free-form equivalent.
+
+#include <iostream>
+#include <chrono>
+#include <lfortran/parser/parser.h>
+#include <libasr/utils.h>
+
+// Best time in microseconds of `n_repeat` prescans and parses of `text`
+int64_t bench(const std::string &text, bool fixed_form, int n_repeat,
+    size_t &n_units)
+{
+    std::vector<std::filesystem::path> include_dirs;
+    int64_t best = -1;
+    for (int i = 0; i < n_repeat; i++) {
+        LCompilers::LocationManager lm;
+        {
+            LCompilers::LocationManager::FileLocations fl;
+            fl.in_filename = fixed_form ? "bench.f" : "bench.f90";
+            lm.files.push_back(fl);
+        }
+        Allocator al(64*1024*1024);
+        LCompilers::diag::Diagnostics diagnostics;
+        LCompilers::CompilerOptions co;
+        co.fixed_form = fixed_form;
+        auto t1 = std::chrono::high_resolution_clock::now();
+        std::string prescanned = LCompilers::LFortran::prescan(text, lm,
+            fixed_form, include_dirs);
+        auto result = LCompilers::LFortran::parse(al, prescanned, diagnostics,
+            co);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        if (!result.ok) {
+            std::cerr << diagnostics.render(lm, co) << std::endl;
+            exit(1);
+        }
+        n_units = result.result->n_items;
+        int64_t t = std::chrono::duration_cast<std::chrono::microseconds>(
+            t2 - t1).count();
+        if (best < 0 || t < best) best = t;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string fixed, free;
+    if (argc > 1) {
+        if (!LCompilers::read_file(argv[1], fixed)) {
+            std::cerr << "Cannot read '" << argv[1] << "'" << std::endl;
+            return 1;
+        }
+    } else {
+        int N = 5000;
+        std::cout << "Construct" << std::endl;
+        for (int i = 0; i < N; i++) {
+            std::string n = std::to_string(i);
+            fixed.append(
+"C     Update of the vectors, variant " + n + R"(
+      SUBROUTINE UPDATE)" + n + R"((N, A, X, Y, Z)
+      INTEGER N, I, J
+      REAL A, X(N), Y(N), Z(N)
+      DOUBLE PRECISION S
+      COMMON /BLK/ SCALE, OFFSET
+      S = 0
+      DO 10 I = 1, N
+         Y(I) = Y(I) + A*X(I)
+     &        + SCALE*X(I)*X(I)
+     &        - OFFSET
+         S = S + Y(I)
+   10 CONTINUE
+      DO 30 J = 1, N
+         DO 20 I = 1, N
+            IF (X(I) .GT. Z(J)) THEN
+               Z(J) = X(I)
+            ELSE
+               Z(J) = Z(J) - 1
+            END IF
+   20    CONTINUE
+   30 CONTINUE
+      IF (S .LT. 0) GOTO 40
+      WRITE (*, 100) N, A, S
+  100 FORMAT ('N = ', I5, ' A = ', F10.4,
+     &        ' S = ', F10.4)
+   40 RETURN
+      END
+
+)");
+            free.append(
+"! Update of the vectors, variant " + n + R"(
+subroutine update)" + n + R"((n, a, x, y, z)
+integer n, i, j
+real a, x(n), y(n), z(n)
+double precision s
+common /blk/ scale, offset
+s = 0
+do 10 i = 1, n
+    y(i) = y(i) + a*x(i) &
+        + scale*x(i)*x(i) &
+        - offset
+    s = s + y(i)
+10 continue
+do 30 j = 1, n
+    do 20 i = 1, n
+        if (x(i) .gt. z(j)) then
+            z(j) = x(i)
+        else
+            z(j) = z(j) - 1
+        end if
+20  continue
+30 continue
+if (s .lt. 0) goto 40
+write (*, 100) n, a, s
+100 format ('N = ', i5, ' A = ', f10.4, &
+        ' S = ', f10.4)
+40 return
+end subroutine
+
+)");
+        }
+    }
+
+    int n_repeat = 5;
+    size_t n_units;
+    std::cout << "Parse fixed-form" << std::endl;
+    int64_t t_fixed = bench(fixed, true, n_repeat, n_units);
+    std::cout << "Fixed-form (best of " << n_repeat << "): " << t_fixed / 1000.
+        << "ms" << std::endl;
+    std::cout << "Number of units: " << n_units << std::endl;
+    std::cout << "Throughput (MB/s): "
+        << (t_fixed > 0 ? fixed.size() / (double)t_fixed : 0) << std::endl;
+    std::cout << "Input size (bytes): " << fixed.size() << std::endl;
+    if (!free.empty()) {
+        std::cout << "Parse free-form" << std::endl;
+        int64_t t_free = bench(free, false, n_repeat, n_units);
+        std::cout << "Free-form (best of " << n_repeat << "): "
+            << t_free / 1000. << "ms" << std::endl;
+        std::cout << "Number of units: " << n_units << std::endl;
+        std::cout << "Fixed-form / free-form time: "
+            << (t_free > 0 ? t_fixed / (double)t_free : 0) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Benchmark of the free-form prescanner on a large generated source file
+//
+// Usage: prescan [file.f90]
+//
+// Without an argument, a 200k line file with comments, strings and
+// continuation lines is generated.
+
+#include <iostream>
+#include <chrono>
+#include <lfortran/parser/parser.h>
+#include <libasr/utils.h>
+
+int main(int argc, char *argv[])
+{
+    std::string text;
+    if (argc > 1) {
+        if (!LCompilers::read_file(argv[1], text)) {
+            std::cerr << "Cannot read '" << argv[1] << "'" << std::endl;
+            return 1;
+        }
+    } else {
+        int N = 40000;
+        std::string st1 = "subroutine coefficients_";
+        std::string st2 = R"(
+    ! Coefficients of the expansion, do not edit
+    real(dp), parameter :: c(4) = [1.2345678901234567e-01_dp, &
+        2.3456789012345678e-02_dp, 3.4567890123456789e-03_dp, & ! tail
+        4.5678901234567890e-04_dp]
+    call report('coefficients & weights: ', c, "done!")
+end subroutine
+)";
+        std::cout << "Construct" << std::endl;
+        for (int i = 0; i < N; i++) {
+            text.append(st1 + std::to_string(i) + st2);
+        }
+    }
+
+    std::vector<std::filesystem::path> include_dirs;
+    int n_repeat = 10;
+    int64_t best = -1;
+    std::string out;
+    std::cout << "Prescan" << std::endl;
+    for (int i = 0; i < n_repeat; i++) {
+        LCompilers::LocationManager lm;
+        {
+            LCompilers::LocationManager::FileLocations fl;
+            fl.in_filename = "prescan.f90";
+            lm.files.push_back(fl);
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        out = LCompilers::LFortran::prescan(text, lm, false, include_dirs);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        int64_t t = std::chrono::duration_cast<std::chrono::microseconds>(
+            t2 - t1).count();
+        if (best < 0 || t < best) best = t;
+    }
+
+    std::cout << "Prescan (best of " << n_repeat << "): " << best / 1000.
+        << "ms" << std::endl;
+    std::cout << "Throughput (MB/s): "
+        << (best > 0 ? text.size() / (double)best : 0) << std::endl;
+    std::cout << "Input size (bytes):  " << text.size() << std::endl;
+    std::cout << "Output size (bytes): " << out.size() << std::endl;
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Benchmark of SymbolTable lookups in resolve-heavy workloads
+//
+// Usage: symtab_lookup [n_symbols]
+//
+// A module scope with `n_symbols` symbols (default 20000) and a chain of
+// nested procedure scopes with a few locals each is created. Names are then
+// resolved from the innermost scope: module symbols (found after missing in
+// every nested scope), locals, and names that are not defined anywhere. The
+// same lookups on a `std::map` per scope are timed for comparison.
+
+#include <iostream>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include <libasr/asr_scopes.h>
+
+using LCompilers::SymbolTable;
+using LCompilers::ASR::symbol_t;
+
+// Resolution through a chain of `std::map`s, the previous implementation
+struct MapScope {
+    std::map<std::string, symbol_t*> scope;
+    MapScope *parent;
+
+    symbol_t *resolve_symbol(const std::string &name) {
+        auto it = scope.find(name);
+        if (it != scope.end()) return it->second;
+        return parent ? parent->resolve_symbol(name) : nullptr;
+    }
+};
+
+symbol_t *fake_symbol(size_t i) {
+    return reinterpret_cast<symbol_t*>((i + 1) * 8);
+}
+
+// Best time in microseconds of `n_repeat` runs of `f`
+template <typename F>
+int64_t bench(int n_repeat, F f) {
+    int64_t best = -1;
+    for (int i = 0; i < n_repeat; i++) {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        f();
+        auto t2 = std::chrono::high_resolution_clock::now();
+        int64_t t = std::chrono::duration_cast<std::chrono::microseconds>(
+            t2 - t1).count();
+        if (best < 0 || t < best) best = t;
+    }
+    return best;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t n_symbols = 20000;
+    if (argc > 1) n_symbols = std::stoul(argv[1]);
+    size_t depth = 6, n_locals = 40;
+
+    std::cout << "Construct" << std::endl;
+    std::vector<std::string> module_names, local_names, missing_names;
+    for (size_t i = 0; i < n_symbols; i++) {
+        module_names.push_back("module_procedure_" + std::to_string(i));
+        missing_names.push_back("undefined_name_" + std::to_string(i));
+    }
+    for (size_t i = 0; i < n_locals; i++) {
+        local_names.push_back("local_" + std::to_string(i));
+    }
+
+    std::vector<SymbolTable*> scopes;
+    std::vector<MapScope*> map_scopes;
+    scopes.push_back(new SymbolTable(nullptr));
+    map_scopes.push_back(new MapScope{{}, nullptr});
+    for (size_t i = 0; i < n_symbols; i++) {
+        scopes[0]->add_symbol(module_names[i], fake_symbol(i));
+        map_scopes[0]->scope[module_names[i]] = fake_symbol(i);
+    }
+    for (size_t d = 1; d <= depth; d++) {
+        scopes.push_back(new SymbolTable(scopes.back()));
+        map_scopes.push_back(new MapScope{{}, map_scopes.back()});
+        for (size_t i = 0; i < n_locals; i++) {
+            scopes.back()->add_symbol(local_names[i], fake_symbol(i));
+            map_scopes.back()->scope[local_names[i]] = fake_symbol(i);
+        }
+    }
+    SymbolTable *inner = scopes.back();
+    MapScope *map_inner = map_scopes.back();
+
+    int n_repeat = 5;
+    size_t found = 0, map_found = 0;
+    struct Workload {
+        std::string name;
+        const std::vector<std::string> &names;
+    };
+    std::vector<Workload> workloads = {
+        {"module symbols", module_names},
+        {"locals", local_names},
+        {"undefined names", missing_names},
+    };
+    for (auto &w : workloads) {
+        // Every workload does the same number of lookups
+        size_t n_rounds = std::max<size_t>(1, n_symbols / w.names.size());
+        int64_t t = bench(n_repeat, [&]() {
+            for (size_t r = 0; r < n_rounds; r++) {
+                for (auto &name : w.names) {
+                    if (inner->resolve_symbol(name)) found++;
+                }
+            }
+        });
+        int64_t t_map = bench(n_repeat, [&]() {
+            for (size_t r = 0; r < n_rounds; r++) {
+                for (auto &name : w.names) {
+                    if (map_inner->resolve_symbol(name)) map_found++;
+                }
+            }
+        });
+        size_t n = n_rounds * w.names.size();
+        std::cout << "Resolve " << w.name << " (" << n << " lookups, best of "
+            << n_repeat << "): SymbolTable " << t / 1000. << "ms, std::map "
+            << t_map / 1000. << "ms, speedup "
+            << (t > 0 ? t_map / (double)t : 0) << std::endl;
+    }
+    if (found != map_found) {
+        std::cerr << "Lookups do not agree" << std::endl;
+        return 1;
+    }
+
+    int64_t t = bench(n_repeat, [&]() {
+        SymbolTable s(nullptr);
+        for (size_t i = 0; i < n_symbols; i++) {
+            s.add_symbol(module_names[i], fake_symbol(i));
+        }
+        for (size_t i = 0; i < n_symbols; i += 2) {
+            s.erase_symbol(module_names[i]);
+        }
+    });
+    std::cout << "Add " << n_symbols << " and erase " << n_symbols / 2
+        << " symbols (best of " << n_repeat << "): " << t / 1000. << "ms"
+        << std::endl;
+    return 0;
+}
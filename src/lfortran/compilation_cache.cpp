@@ -0,0 +1,279 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <libasr/config.h>
+#include <libasr/exception.h>
+#include <libasr/modfile.h>
+#include <libasr/string_utils.h>
+#include <libasr/pass/pass_manager.h>
+#include <lfortran/compilation_cache.h>
+#include <lfortran/parser/parser.h>
+#include <lfortran/parser/preprocessor.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace LCompilers::LFortran {
+
+namespace {
+
+// All the options that can change the outputs of a compilation
+std::string options_fingerprint(const CompilerOptions &co, bool assembly)
+{
+    std::stringstream ss;
+    const PassOptions &po = co.po;
+    ss << "assembly=" << assembly << "\n";
+    ss << "mod_files_dir=" << po.mod_files_dir.string() << "\n";
+    for (auto &dir : po.include_dirs) ss << "include_dir=" << dir.string() << "\n";
+    ss << "default_integer_kind=" << po.default_integer_kind << "\n";
+    ss << "run_fun=" << po.run_fun << "\n";
+    ss << "runtime_library_dir=" << po.runtime_library_dir << "\n";
+    ss << "po.flags=" << po.always_run << po.inline_external_symbol_calls
+        << po.fast << po.verbose << po.dump_all_passes << po.dump_fortran
+        << po.pass_cumulative << po.disable_main
+        << po.use_loop_variable_after_loop << po.realloc_lhs
+        << po.module_name_mangling << po.global_symbols_mangling
+        << po.intrinsic_symbols_mangling << po.all_symbols_mangling
+        << po.bindc_mangling << po.fortran_mangling << po.mangle_underscore
+        << po.json << po.no_loc << po.visualize << po.tree
+        << po.with_intrinsic_mods << po.c_mangling << po.enable_cpython
+        << po.c_skip_bindpy_pass << po.openmp << po.enable_gpu_offloading
+        << "\n";
+    ss << "unroll_factor=" << po.unroll_factor << "\n";
+    ss << "tile_cache_size=" << po.tile_cache_size << "\n";
+    ss << "blas=" << po.blas << "\n";
+    for (auto &i : po.skip_optimization_func_instantiation) {
+        ss << "skip_optimization_func_instantiation=" << i << "\n";
+    }
+    for (auto &path : co.runtime_linker_paths) ss << "runtime_linker_path=" << path << "\n";
+    for (auto &def : co.c_preprocessor_defines) ss << "define=" << def << "\n";
+    ss << "co.flags=" << co.fixed_form << co.interactive << co.c_preprocessor
+        << co.prescan << co.disable_main << co.symtab_only
+        << co.show_stacktrace << co.use_colors << co.indent << co.json
+        << co.tree << co.visualize << co.fast << co.openmp << co.lookup_name
+        << co.rename_symbol << co.continue_compilation << co.semantics_only
+        << co.generate_object_code << co.separate_compilation
+        << co.no_warnings << co.disable_style << co.logical_casting
+        << co.no_error_banner << co.enable_bounds_checking << co.new_parser
+        << co.implicit_typing << co.implicit_interface
+        << co.implicit_argument_casting << co.print_leading_space << co.rtlib
+        << co.use_loop_variable_after_loop << co.emit_debug_info
+        << co.emit_debug_line_column << co.enable_cpython
+        << co.enable_symengine << co.link_numpy << co.run
+        << co.legacy_array_sections << co.ignore_pragma << co.stack_arrays
+        << co.wasm_html << "\n";
+    ss << "openmp_lib_dir=" << co.openmp_lib_dir << "\n";
+    ss << "error_format=" << co.error_format << "\n";
+    ss << "target=" << co.target << "\n";
+    ss << "emcc_embed=" << co.emcc_embed << "\n";
+    for (auto &path : co.import_paths) ss << "import_path=" << path << "\n";
+    ss << "platform=" << co.platform << "\n";
+    return ss.str();
+}
+
+std::filesystem::path entry_dir(const std::string &cache_dir,
+        const std::string &key)
+{
+    return std::filesystem::path(cache_dir) / key.substr(0, 2) / key;
+}
+
+// Finds the modfile of module `name` the same way `find_and_load_module` does
+std::string find_modfile(const std::string &name, const PassOptions &po)
+{
+    std::vector<std::filesystem::path> dirs;
+    dirs.push_back(po.runtime_library_dir);
+    dirs.push_back(po.mod_files_dir);
+    dirs.insert(dirs.end(), po.include_dirs.begin(), po.include_dirs.end());
+    for (auto &dir : dirs) {
+        std::filesystem::path path = dir / (name + ".mod");
+        if (std::filesystem::exists(path)) return path.string();
+    }
+    return "";
+}
+
+// Returns the hash of the modfile of module `name`, or "" if not found
+std::string modfile_hash(const std::string &name, const PassOptions &po)
+{
+    std::string path = find_modfile(name, po);
+    std::string modfile;
+    if (path.empty() || !read_file(path, modfile)) return "";
+    return hash_to_hex(hash_fnv1a(modfile)) + "-" + std::to_string(modfile.size());
+}
+
+// Returns the hash of the ASR in the modfile of module `name` (see
+// `structural_hash()`), or "" if not found
+std::string modfile_asr_hash(const std::string &name, const PassOptions &po)
+{
+    std::string path = find_modfile(name, po);
+    uint64_t hash;
+    if (path.empty() || !LCompilers::modfile_asr_hash(path, hash)) return "";
+    return hash_to_hex(hash);
+}
+
+bool write_file(const std::filesystem::path &path, const std::string &text)
+{
+    std::ofstream out(path, std::ofstream::out | std::ofstream::binary);
+    out << text;
+    return out.good();
+}
+
+} // namespace
+
+std::string CompilationCache::get_key(const std::string &infile,
+        const std::string &input, CompilerOptions &compiler_options,
+        const PassManager &lpm, bool assembly)
+{
+    // Preprocess and prescan the same way as `FortranEvaluator::get_ast2`,
+    // so that the key changes when an included file changes
+    std::string code = input;
+    try {
+        LocationManager lm;
+        {
+            LocationManager::FileLocations fl;
+            fl.in_filename = infile;
+            lm.files.push_back(fl);
+            lm.file_ends.push_back(input.size());
+        }
+        if (compiler_options.c_preprocessor) {
+            CPreprocessor cpp(compiler_options);
+            diag::Diagnostics diagnostics;
+            Result<std::string> res = cpp.run(input, lm, cpp.macro_definitions,
+                diagnostics);
+            // Do not cache files with preprocessor errors
+            if (!res.ok) return "";
+            code = res.result;
+        }
+        if (compiler_options.prescan || compiler_options.fixed_form) {
+            std::vector<std::filesystem::path> include_dirs;
+            include_dirs.push_back(parent_path(infile));
+            include_dirs.insert(include_dirs.end(),
+                compiler_options.po.include_dirs.begin(),
+                compiler_options.po.include_dirs.end());
+            code = prescan(code, lm, compiler_options.fixed_form, include_dirs);
+        }
+    } catch (const LCompilersException &) {
+        // The compilation itself will report the error
+        return "";
+    }
+    // --pass and --skip-pass are stored in the PassManager
+    std::string options = options_fingerprint(compiler_options, assembly)
+        + lpm.fingerprint();
+    uint64_t hash = hash_fnv1a(LFORTRAN_VERSION);
+    hash = hash_fnv1a(infile, hash);
+    hash = hash_fnv1a(options, hash);
+    hash = hash_fnv1a(code, hash);
+    return hash_to_hex(hash) + "-" + std::to_string(code.size());
+}
+
+bool CompilationCache::restore(const std::string &key,
+        const std::string &outfile, const CompilerOptions &compiler_options,
+        std::string &diagnostics)
+{
+    if (key.empty()) return false;
+    std::filesystem::path dir = entry_dir(cache_dir, key);
+    std::string deps;
+    if (!read_file((dir / "deps").string(), deps)) return false;
+    // Every line is `<module name> <modfile hash> <ASR hash>`
+    std::istringstream deps_stream(deps);
+    std::string line;
+    bool only_asr_unchanged = false;
+    while (std::getline(deps_stream, line)) {
+        std::istringstream line_stream(line);
+        std::string name, hash, asr_hash;
+        if (!(line_stream >> name >> hash >> asr_hash)) return false;
+        if (modfile_hash(name, compiler_options.po) == hash) continue;
+        // The modfile changed, but if its ASR and the lines and columns of
+        // its code did not (e.g. a comment at the end of a line changed),
+        // the outputs stay the same. Debug information is only reused for an
+        // identical modfile.
+        if (compiler_options.emit_debug_info
+                || modfile_asr_hash(name, compiler_options.po) != asr_hash) {
+            return false;
+        }
+        only_asr_unchanged = true;
+    }
+    if (!read_file((dir / "stderr").string(), diagnostics)) return false;
+    // The cached diagnostics might point to the old lines of the module
+    if (only_asr_unchanged && !diagnostics.empty()) return false;
+
+    std::error_code ec;
+    std::filesystem::copy_file(dir / "object", outfile,
+        std::filesystem::copy_options::overwrite_existing, ec);
+    if (ec) return false;
+    for (auto &entry : std::filesystem::directory_iterator(dir / "mods", ec)) {
+        std::string modfile;
+        if (!read_file(entry.path().string(), modfile)
+                || !write_modfile((compiler_options.po.mod_files_dir
+                    / entry.path().filename()).string(), modfile)) {
+            return false;
+        }
+    }
+    return !ec;
+}
+
+void CompilationCache::store(const std::string &key,
+        const std::string &outfile, const std::vector<std::string> &mod_files,
+        const std::vector<std::string> &loaded_modules,
+        const CompilerOptions &compiler_options,
+        const std::string &diagnostics)
+{
+    if (key.empty()) return;
+    std::filesystem::path dir = entry_dir(cache_dir, key);
+    // Populate a private directory first and rename it at the end, so that
+    // concurrent compilations never see a partial entry
+    std::string suffix = ".tmp";
+#ifndef _WIN32
+    suffix += std::to_string(getpid());
+#endif
+    std::filesystem::path tmp_dir = dir.string() + suffix;
+    std::error_code ec;
+    std::filesystem::remove_all(tmp_dir, ec);
+    std::filesystem::create_directories(tmp_dir / "mods", ec);
+    if (ec) return;
+
+    std::string deps;
+    for (auto &name : loaded_modules) {
+        std::string hash = modfile_hash(name, compiler_options.po);
+        std::string asr_hash = modfile_asr_hash(name, compiler_options.po);
+        if (hash.empty() || asr_hash.empty()) {
+            std::filesystem::remove_all(tmp_dir, ec);
+            return;
+        }
+        deps += name + " " + hash + " " + asr_hash + "\n";
+    }
+    bool ok = write_file(tmp_dir / "deps", deps)
+        && write_file(tmp_dir / "stderr", diagnostics);
+    std::filesystem::copy_file(outfile, tmp_dir / "object", ec);
+    ok = ok && !ec;
+    for (auto &mod_file : mod_files) {
+        std::filesystem::copy_file(mod_file,
+            tmp_dir / "mods" / std::filesystem::path(mod_file).filename(), ec);
+        ok = ok && !ec;
+    }
+    if (ok) {
+        std::filesystem::remove_all(dir, ec);
+        std::filesystem::rename(tmp_dir, dir, ec);
+    }
+    std::filesystem::remove_all(tmp_dir, ec);
+}
+
+std::vector<std::string> modules_loaded_from_modfiles(
+    const ASR::TranslationUnit_t &u)
+{
+    std::vector<std::string> modules;
+    for (auto &item : u.m_symtab->get_scope()) {
+        if (ASR::is_a<ASR::Module_t>(*item.second)) {
+            ASR::Module_t *m = ASR::down_cast<ASR::Module_t>(item.second);
+            // Intrinsic modules only change with the LFortran version,
+            // which is part of the key
+            if (m->m_loaded_from_mod && !m->m_intrinsic) {
+                modules.push_back(m->m_name);
+            }
+        }
+    }
+    return modules;
+}
+
+} // namespace LCompilers::LFortran
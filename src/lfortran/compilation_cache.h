@@ -0,0 +1,67 @@
+#ifndef LFORTRAN_COMPILATION_CACHE_H
+#define LFORTRAN_COMPILATION_CACHE_H
+
+#include <string>
+#include <vector>
+
+#include <libasr/asr.h>
+#include <libasr/utils.h>
+
+namespace LCompilers {
+class PassManager;
+}
+
+namespace LCompilers::LFortran {
+
+/*
+ * Content addressed cache of the outputs of compiling one source file to an
+ * object file: the object file, the .mod files and the rendered warnings.
+ *
+ * An entry is found by a key computed from the preprocessed (and prescanned)
+ * source, the compiler options, the selected passes and the LFortran
+ * version. Each entry also
+ * records the hashes of the (non-intrinsic) modfiles that the compilation
+ * loaded, directly or indirectly; the entry is only used if all of them are
+ * unchanged. A modfile whose module ASR and code locations are unchanged
+ * (see `structural_hash()`) also matches, unless the outputs could contain
+ * its source lines: with debug information or with diagnostics. This hash
+ * is a key of the whole module: any edit that moves code of the module to
+ * other lines changes it. The cache is not incremental, an entry is reused
+ * for the whole source file or not at all.
+ *
+ * Layout: <cache_dir>/<key[0:2]>/<key>/ contains the files `object`,
+ * `stderr`, `deps` and the directory `mods` with the .mod files.
+ */
+class CompilationCache {
+public:
+    CompilationCache(const std::string &cache_dir) : cache_dir{cache_dir} {}
+
+    // Returns the key for compiling `infile` with the contents `input`
+    std::string get_key(const std::string &infile, const std::string &input,
+        CompilerOptions &compiler_options, const PassManager &lpm,
+        bool assembly);
+
+    // Copies the cached object file to `outfile` and the cached .mod files
+    // to the modfile directory. Returns false on a cache miss.
+    bool restore(const std::string &key, const std::string &outfile,
+        const CompilerOptions &compiler_options, std::string &diagnostics);
+
+    // Stores the outputs of a successful compilation. `mod_files` are the
+    // written modfiles and `loaded_modules` the modules loaded from modfiles.
+    void store(const std::string &key, const std::string &outfile,
+        const std::vector<std::string> &mod_files,
+        const std::vector<std::string> &loaded_modules,
+        const CompilerOptions &compiler_options,
+        const std::string &diagnostics);
+
+private:
+    std::string cache_dir;
+};
+
+// Names of the non-intrinsic modules loaded from modfiles in `u`
+std::vector<std::string> modules_loaded_from_modfiles(
+    const ASR::TranslationUnit_t &u);
+
+} // namespace LCompilers::LFortran
+
+#endif // LFORTRAN_COMPILATION_CACHE_H
@@ -17,6 +17,7 @@
 #include <lfortran/pickle.h>
 #include <libasr/pickle.h>
 #include <libasr/utils.h>
+#include <libasr/trace.h>
 #include <libasr/asr_lookup_name.h>
 
 
@@ -200,6 +201,7 @@ Result<LFortran::AST::TranslationUnit_t*> FortranEvaluator::get_ast2(
     std::string tmp;
     if (compiler_options.c_preprocessor) {
         // Preprocessor
+        trace::Scope trace_scope("C preprocessor");
         LFortran::CPreprocessor cpp(compiler_options);
         Result<std::string> res = cpp.run(code_orig, lm, cpp.macro_definitions, diagnostics);
         if (res.ok) {
@@ -209,8 +211,10 @@ Result<LFortran::AST::TranslationUnit_t*> FortranEvaluator::get_ast2(
             return res.error;
         }
         code = &tmp;
+        record_memory_usage(compiler_options.po, "C preprocessor", al);
     }
     if (compiler_options.prescan || compiler_options.fixed_form) {
+        trace::Scope trace_scope("Prescan");
         std::vector<std::filesystem::path> include_dirs;
         include_dirs.push_back(parent_path(lm.files.back().in_filename));
         include_dirs.insert(include_dirs.end(),
@@ -218,9 +222,12 @@ Result<LFortran::AST::TranslationUnit_t*> FortranEvaluator::get_ast2(
                             compiler_options.po.include_dirs.end());
         tmp = LFortran::prescan(*code, lm, compiler_options.fixed_form, include_dirs);
         code = &tmp;
+        record_memory_usage(compiler_options.po, "Prescan", al);
     }
     Result<LFortran::AST::TranslationUnit_t*>
         res = LFortran::parse(al, *code, diagnostics, compiler_options);
+    // The free-form tokenizer runs on demand from the parser
+    record_memory_usage(compiler_options.po, "Tokenizer + parser", al);
     if (res.ok) {
         return res.result;
     } else {
@@ -293,8 +300,10 @@ Result<ASR::TranslationUnit_t*> FortranEvaluator::get_asr3(
         }
         symbol_table->mark_all_variables_external(al);
     }
+    trace::Scope trace_scope("Semantics");
     auto res = LFortran::ast_to_asr(al, ast, diagnostics, symbol_table,
         compiler_options.symtab_only, compiler_options, lm);
+    record_memory_usage(compiler_options.po, "AST -> ASR", al);
     if (res.ok) {
         asr = res.result;
     } else {
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+#include <lfortran/module_dependencies.h>
+
+namespace LCompilers::LFortran {
+
+namespace {
+
+// Splits one source line into lowercase identifiers and the punctuation
+// tokens `,` `(` `)` `:` and `::`. Stops at a `!` comment.
+std::vector<std::string> tokenize_line(const std::string &input,
+        size_t begin, size_t end)
+{
+    std::vector<std::string> tokens;
+    size_t i = begin;
+    while (i < end) {
+        char c = input[i];
+        if (c == '!') break;
+        if (std::isalpha((unsigned char)c) || c == '_') {
+            size_t start = i;
+            while (i < end && (std::isalnum((unsigned char)input[i])
+                    || input[i] == '_')) i++;
+            std::string word = input.substr(start, i - start);
+            std::transform(word.begin(), word.end(), word.begin(),
+                [](unsigned char ch) { return std::tolower(ch); });
+            tokens.push_back(word);
+        } else if (c == ':' && i + 1 < end && input[i+1] == ':') {
+            tokens.push_back("::");
+            i += 2;
+        } else if (c == ',' || c == '(' || c == ')' || c == ':') {
+            tokens.push_back(std::string(1, c));
+            i++;
+        } else if (c == ' ' || c == '\t' || c == '\r') {
+            i++;
+        } else {
+            // Anything else (strings, operators, ...) is not part of
+            // the statements we are interested in
+            tokens.push_back(std::string(1, c));
+            i++;
+        }
+    }
+    return tokens;
+}
+
+bool is_identifier(const std::string &token) {
+    return !token.empty() &&
+        (std::isalpha((unsigned char)token[0]) || token[0] == '_');
+}
+
+void add_unique(std::vector<std::string> &v, const std::string &name) {
+    if (std::find(v.begin(), v.end(), name) == v.end()) {
+        v.push_back(name);
+    }
+}
+
+} // namespace
+
+ModuleDependencies scan_module_dependencies(const std::string &input)
+{
+    ModuleDependencies deps;
+    size_t pos = 0;
+    while (pos < input.size()) {
+        size_t eol = input.find('\n', pos);
+        if (eol == std::string::npos) eol = input.size();
+        std::vector<std::string> t = tokenize_line(input, pos, eol);
+        pos = eol + 1;
+        if (t.size() < 2) continue;
+
+        if (t[0] == "module") {
+            // `module name`, but not `module procedure`, `module function`,
+            // ... which all have more tokens on the line
+            if (t.size() == 2 && is_identifier(t[1])) {
+                add_unique(deps.provides, t[1]);
+            }
+        } else if (t[0] == "submodule") {
+            // `submodule (ancestor[:parent]) name`
+            if (t.size() >= 3 && t[1] == "(" && is_identifier(t[2])) {
+                add_unique(deps.uses, t[2]);
+            }
+        } else if (t[0] == "use") {
+            // `use name`, `use :: name`, `use, intrinsic :: name`,
+            // `use, non_intrinsic :: name`
+            size_t i = 1;
+            if (t[i] == ",") {
+                if (i + 1 >= t.size() || t[i+1] == "intrinsic") continue;
+                i += 2;
+            }
+            if (i < t.size() && t[i] == "::") i++;
+            if (i < t.size() && is_identifier(t[i])) {
+                add_unique(deps.uses, t[i]);
+            }
+        }
+    }
+    // A file using its own modules does not depend on itself
+    deps.uses.erase(std::remove_if(deps.uses.begin(), deps.uses.end(),
+        [&](const std::string &name) {
+            return std::find(deps.provides.begin(), deps.provides.end(),
+                name) != deps.provides.end();
+        }), deps.uses.end());
+    return deps;
+}
+
+std::vector<std::vector<size_t>> module_dependency_graph(
+    const std::vector<ModuleDependencies> &files)
+{
+    std::map<std::string, size_t> module_to_file;
+    for (size_t i = 0; i < files.size(); i++) {
+        for (auto &name : files[i].provides) {
+            // If several files define the same module, the first one wins
+            module_to_file.insert({name, i});
+        }
+    }
+    std::vector<std::vector<size_t>> graph(files.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        for (auto &name : files[i].uses) {
+            auto it = module_to_file.find(name);
+            if (it == module_to_file.end() || it->second == i) continue;
+            if (std::find(graph[i].begin(), graph[i].end(), it->second)
+                    == graph[i].end()) {
+                graph[i].push_back(it->second);
+            }
+        }
+    }
+    return graph;
+}
+
+} // namespace LCompilers::LFortran
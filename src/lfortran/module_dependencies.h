@@ -0,0 +1,29 @@
+#ifndef LFORTRAN_MODULE_DEPENDENCIES_H
+#define LFORTRAN_MODULE_DEPENDENCIES_H
+
+#include <string>
+#include <vector>
+
+namespace LCompilers::LFortran {
+
+/*
+ * Module dependencies of a single source file, as determined by a quick
+ * line based scan of the `module` / `submodule` / `use` statements (no
+ * parsing). All names are lowercase.
+ */
+struct ModuleDependencies {
+    std::vector<std::string> provides; // modules defined in the file
+    std::vector<std::string> uses; // non-intrinsic modules used by the file
+};
+
+ModuleDependencies scan_module_dependencies(const std::string &input);
+
+// Returns, for each file, the indices of the other files that define a module
+// it uses. Modules that are not defined by any of the files (intrinsic or
+// precompiled modules) do not create a dependency.
+std::vector<std::vector<size_t>> module_dependency_graph(
+    const std::vector<ModuleDependencies> &files);
+
+} // namespace LCompilers::LFortran
+
+#endif // LFORTRAN_MODULE_DEPENDENCIES_H
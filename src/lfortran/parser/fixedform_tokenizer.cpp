@@ -6,6 +6,8 @@ fed into our Bison parser, that is shared with the free-form parser.
 
 Note: The prescanner removes CR, so we only handle LF here.
 */
+#include <cstring>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 
@@ -23,7 +25,9 @@ int position = 0;
 
 namespace LCompilers::LFortran {
 
-const std::unordered_map<std::string, yytokentype> identifiers_map = {
+// The keys are string literals, tokens that are not in the source point to
+// them (see `push_token_no_advance`)
+const std::unordered_map<std::string_view, yytokentype> identifiers_map = {
     {"EOF", END_OF_FILE},
     {"\n", TK_NEWLINE},
     {"name", TK_NAME},
@@ -268,7 +272,7 @@ const std::unordered_map<std::string, yytokentype> identifiers_map = {
 };
 
 // star-forms must appear before non-stars
-const std::vector<std::string> declarators{
+const std::vector<std::string_view> declarators{
             "integer*",
             "integer",
 	    "real*",
@@ -289,17 +293,29 @@ const std::vector<std::string> declarators{
             "class"
         };
 
-std::vector<std::string> lines{};
+const std::vector<std::string_view> io_names{"open", "read", "write", "format", "close", "print"};
 
-std::vector<std::string> io_names{"open", "read", "write", "format", "close", "print"};
+// Keywords of the statements that are tokenized as the keyword followed by
+// the rest of the line, indexed by their first character. None is a prefix
+// of another one or of the other statement keywords, so the order of the
+// lookup does not matter.
+const std::vector<std::vector<std::string_view>> simple_statements = [] {
+    std::vector<std::vector<std::string_view>> table(256);
+    for (std::string_view kw : {"allocate", "backspace", "continue",
+            "deallocate", "endfile", "entry", "equivalence", "exit", "flush",
+            "goto", "intrinsic", "return", "rewind", "save", "stop"}) {
+        table[(unsigned char)kw[0]].push_back(kw);
+    }
+    return table;
+}();
 
-void FixedFormTokenizer::set_string(const std::string &str)
+void FixedFormTokenizer::set_string(std::string_view str)
 {
     // The input string must be NULL terminated, otherwise the tokenizertostr will
     // not detect the end of string. After C++11, the std::string is guaranteed
     // to end with \0, but we check this here just in case.
-    LCOMPILERS_ASSERT(str[str.size()] == '\0');
-    cur = (unsigned char *)(&str[0]);
+    LCOMPILERS_ASSERT(str.data()[str.size()] == '\0');
+    cur = (unsigned char *)(str.data());
     string_start = cur;
     cur_line = cur;
     line_num = 1;
@@ -338,7 +354,7 @@ struct FixedFormRecursiveDescent {
     }
 
     // Are the next characters in the `cur` stream equal to `str`?
-    bool next_is(unsigned char const *cur, const std::string &str) {
+    bool next_is(unsigned char const *cur, std::string_view str) {
 	for(const char s : str) {
 	    if (!s || *cur++ != s) return false;
 	}
@@ -372,7 +388,6 @@ struct FixedFormRecursiveDescent {
         std::string label;
         label.assign((char*)cur, reserved_cols);
         if (is_integer(label)) {
-            lines.push_back(label);
             YYSTYPE y;
             std::string::iterator end = std::remove(label.begin(), label.end(), ' ');
             label.erase(end, label.end());
@@ -435,25 +450,36 @@ struct FixedFormRecursiveDescent {
         if (*cur == '\n') cur++;
     }
 
-    // Push the token_type, YYSTYPE and Location of the token_str at `cur`.
-    // (Does not modify `cur`.)
-    void push_token_no_advance_token(unsigned char *cur, const std::string &token_str,
+    // Push the token_type, YYSTYPE and Location of the token `str` at `cur`.
+    // The text is not copied, `str` must point into the source or to a
+    // string literal.
+    void push_token_view(unsigned char *cur, std::string_view str,
             yytokentype const token_type) {
         YYSTYPE yy;
-        yy.string.from_str(m_a, token_str);
+        yy.string.p = const_cast<char*>(str.data());
+        yy.string.n = str.size();
         stypes.push_back(yy);
         tokens.push_back(token_type);
         Location loc;
         loc.first = cur - string_start;
-        loc.last = cur - string_start + token_str.size();
+        loc.last = cur - string_start + str.size();
         locations.push_back(loc);
     }
 
+    // Push the token_type, YYSTYPE and Location of the token_str at `cur`.
+    // (Does not modify `cur`.)
+    void push_token_no_advance_token(unsigned char *cur, const std::string &token_str,
+            yytokentype const token_type) {
+        Str str;
+        str.from_str(m_a, token_str);
+        push_token_view(cur, std::string_view(str.p, str.n), token_type);
+    }
+
     // token_type automatically determined
-    void push_token_no_advance(unsigned char *cur, const std::string &token_str) {
-	auto it = identifiers_map.find(token_str);
-	LCOMPILERS_ASSERT(it != identifiers_map.end());
-        push_token_no_advance_token(cur, token_str, it->second);
+    void push_token_no_advance(unsigned char *cur, std::string_view token_str) {
+        auto it = identifiers_map.find(token_str);
+        LCOMPILERS_ASSERT(it != identifiers_map.end());
+        push_token_view(cur, it->first, it->second);
     }
 
     void push_integer_no_advance(unsigned char *cur, int32_t n) {
@@ -471,9 +497,12 @@ struct FixedFormRecursiveDescent {
 
     // Same as push_token_no_advance(), but update `cur` and `t.cur`.
     // token_type is automatically determined
-    void push_token_advance(unsigned char *&cur, const std::string &token_str) {
+    void push_token_advance(unsigned char *&cur, std::string_view token_str) {
         LCOMPILERS_ASSERT(next_is(cur, token_str))
-        push_token_no_advance(cur, token_str);
+        auto it = identifiers_map.find(token_str);
+        LCOMPILERS_ASSERT(it != identifiers_map.end());
+        push_token_view(cur, std::string_view((char*)cur, token_str.size()),
+            it->second);
         cur += token_str.size();
         t.cur = cur;
     }
@@ -576,7 +605,7 @@ struct FixedFormRecursiveDescent {
     }
 
     // cur points exactly to "str"
-    bool try_next(unsigned char *&cur, const std::string &str) {
+    bool try_next(unsigned char *&cur, std::string_view str) {
         if (next_is(cur, str)) {
             cur += str.size();
             return true;
@@ -721,9 +750,6 @@ struct FixedFormRecursiveDescent {
      */
     void tokenize_until(unsigned char *end) {
         LCOMPILERS_ASSERT(t.cur < end)
-        // TODO: Is this needed?
-        std::string line{tostr(t.cur, end)};
-        lines.push_back(line);
         Location loc;
         ptrdiff_t len;
         while (t.cur < end) {
@@ -736,11 +762,12 @@ struct FixedFormRecursiveDescent {
                     y2.int_suffix.int_n,
                     y2.int_suffix.int_kind);
             } else if (token == yytokentype::TK_STRING) {
-                std::string tk{tostr(t.tok+1, t.tok + len-1)};
-                y2.string.from_str(m_a, tk);
+                // The text is not copied, the source outlives the tokens
+                y2.string.p = (char*)t.tok + 1;
+                y2.string.n = len - 2;
             } else {
-                std::string tk{tostr(t.tok, t.tok + len)};
-                y2.string.from_str(m_a, tk);
+                y2.string.p = (char*)t.tok;
+                y2.string.n = len;
             }
             stypes.push_back(y2);
             locations.push_back(loc);
@@ -831,7 +858,17 @@ struct FixedFormRecursiveDescent {
         return false;  // Not an assignment if no '=' found
     }
 
+    bool is_declarator(unsigned char *cur) {
+        for (const auto &declarator : declarators) {
+            if (next_is(cur, declarator)) return true;
+        }
+        return false;
+    }
+
     bool lex_declaration(unsigned char *&cur) {
+        // Quick check for the common case of a statement that is not a
+        // declaration
+        if (!is_declarator(cur)) return false;
         unsigned char *start = cur;
         next_line(cur);
 
@@ -855,7 +892,7 @@ struct FixedFormRecursiveDescent {
 		       after the star, so that we correctly parse "character*2d3v" as "character*2 d3v"
 		       instead of "character*2d3 v", which is illegal. */
 		    push_token_advance(cur, declarator.substr(0, declarator.size() - 1));
-		    push_token_advance(cur, std::string("*"));
+		    push_token_advance(cur, "*");
 		    unsigned char *int_start = cur;
 		    if (try_integer(cur)) {
 			int32_t val = std::atoi((char*)int_start);
@@ -1074,28 +1111,12 @@ struct FixedFormRecursiveDescent {
         }
 
         // careful addition -- `IF` and `DO` terminals are `CONTINUE`, too
-        if (next_is(cur, "continue")) {
-            push_token_advance(cur, "continue");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "backspace")) {
-            push_token_advance(cur, "backspace");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "rewind")) {
-            push_token_advance(cur, "rewind");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "endfile")) {
-            push_token_advance(cur, "endfile");
-            tokenize_line(cur);
-            return true;
+        for (const auto &keyword : simple_statements[*cur]) {
+            if (next_is(cur, keyword)) {
+                push_token_advance(cur, keyword);
+                tokenize_line(cur);
+                return true;
+            }
         }
 
         if (next_is(cur, "interface")) {
@@ -1103,70 +1124,10 @@ struct FixedFormRecursiveDescent {
             return true;
         }
 
-        if (next_is(cur, "exit")) {
-            push_token_advance(cur, "exit");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "flush")) {
-            push_token_advance(cur, "flush");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "allocate")) {
-            push_token_advance(cur, "allocate");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "deallocate")) {
-            push_token_advance(cur, "deallocate");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "goto")) {
-            push_token_advance(cur, "goto");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "return")) {
-            push_token_advance(cur, "return");
-            tokenize_line(cur);
-            return true;
-        }
-
         if (next_is(cur, "common")) {
             return lex_common_block(cur);
         }
 
-        if (next_is(cur, "save")) {
-            push_token_advance(cur, "save");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "entry")) {
-            push_token_advance(cur, "entry");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "intrinsic")) {
-            push_token_advance(cur, "intrinsic");
-            tokenize_line(cur);
-            return true;
-        }
-
-        if (next_is(cur, "equivalence")) {
-            push_token_advance(cur, "equivalence");
-            tokenize_line(cur);
-            return true;
-        }
-
         if (next_is(cur, "implicit")) {
             lex_implicit(cur);
             return true;
@@ -1177,12 +1138,6 @@ struct FixedFormRecursiveDescent {
             return true;
         }
 
-        if (next_is(cur, "stop")) {
-            push_token_advance(cur, "stop");
-            tokenize_line(cur);
-            return true;
-        }
-
         if (next_is(cur, "errorstop")) {
             push_token_advance(cur, "error");
             push_token_advance(cur, "stop");
@@ -1677,9 +1632,9 @@ struct FixedFormRecursiveDescent {
 			const std::vector<std::string>& keywords) {
         unsigned char *cpy = cur;
         unsigned char *nextline = cur; next_line(nextline);
-        std::string line{tostr(cur, nextline-1)};
+        std::string_view line((char*)cur, nextline-1-cur);
         // current line does not contain type -> we abort
-        if (!(line.find(declaration_type) != std::string::npos)) return false;
+        if (line.find(declaration_type) == std::string_view::npos) return false;
         std::vector<std::string> kw_found;
         std::vector<std::string> decls{keywords.begin(), keywords.end()};
         while(decls.size() != 0) {
@@ -1756,9 +1711,9 @@ struct FixedFormRecursiveDescent {
     }
 
     bool lex_procedure(unsigned char *&cur) {
-	const std::vector<std::string> subroutine_keywords{"recursive", "pure",
+	static const std::vector<std::string> subroutine_keywords{"recursive", "pure",
             "elemental"};
-        const std::vector<std::string> function_keywords{"recursive", "pure",
+        static const std::vector<std::string> function_keywords{"recursive", "pure",
             "elemental", "real*", "real",
 	    "character*(*)",
             "character*", "character",
@@ -1824,7 +1779,12 @@ bool FixedFormTokenizer::tokenize_input(diag::Diagnostics &diagnostics, Allocato
     try {
         FixedFormRecursiveDescent f(diagnostics, al);
         f.string_start = string_start;
-        //f.t.set_string(lines[lines.size()-1]);
+        // Most statements have a few tokens per line of the prescanned
+        // source, reserve for a dense source to avoid the reallocations
+        size_t n = std::strlen((char*)string_start) / 4;
+        f.tokens.reserve(n);
+        f.stypes.reserve(n);
+        f.locations.reserve(n);
         f.t.cur = string_start;
         f.t.string_start = string_start;
         f.t.cur_line = string_start;
@@ -1,6 +1,8 @@
 #ifndef LFORTRAN_SRC_PARSER_FIXEDFORM_TOKENIZER_H
 #define LFORTRAN_SRC_PARSER_FIXEDFORM_TOKENIZER_H
 
+#include <string_view>
+
 #include <libasr/exception.h>
 #include <lfortran/parser/parser_stype.h>
 
@@ -32,7 +34,7 @@ public:
 public:
     // Set the string to tokenize. The caller must ensure `str` will stay valid
     // as long as `lex` is being called.
-    void set_string(const std::string &str);
+    void set_string(std::string_view str);
 
     // Tokenizes the whole input and saves all tokens into an internal array
     // The lex function then just iterates on this array and returns the next
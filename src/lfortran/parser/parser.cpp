@@ -1,11 +1,27 @@
 #include <iostream>
 #include <string>
 #include <cctype>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HAVE_PRESCAN_SSE2
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HAVE_PRESCAN_AVX2
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #include <lfortran/parser/parser.h>
 #include <lfortran/parser/parser.tab.hh>
 #include <libasr/diagnostics.h>
 #include <libasr/string_utils.h>
+#include <libasr/trace.h>
 #include <lfortran/parser/parser_exception.h>
 #include <lfortran/parser/fixedform_tokenizer.h>
 #include <lfortran/utils.h>
@@ -212,12 +228,281 @@ void fix_program_without_program_line(Allocator &al, AST::TranslationUnit_t &ast
     ast.n_items = global_items.size();
 }
 
+namespace {
+
+// Kind of a line of free-form source, see `classify_line()`
+enum class LineKind {
+    Blank,     // Empty, comment or preprocessor line
+    UnitStart, // Starts a program unit or an interface block
+    UnitEnd,   // Ends a program unit or an interface block
+    Other
+};
+
+// Reads the statement on a single line of source
+class LineScanner {
+    const char *p, *e;
+public:
+    LineScanner(const char *b, const char *e) : p{b}, e{e} {}
+
+    char peek() {
+        while (p < e && (*p == ' ' || *p == '\t')) p++;
+        return p < e ? *p : '\n';
+    }
+
+    // True at the end of the statement, a `;` does not end it here
+    bool at_end() {
+        char c = peek();
+        return c == '\n' || c == '\r' || c == '!';
+    }
+
+    bool at_name() {
+        return std::isalpha((unsigned char)peek());
+    }
+
+    // Returns the next name in lower case, or "" if there is none
+    std::string word() {
+        std::string w;
+        if (!at_name()) return w;
+        while (p < e && (std::isalnum((unsigned char)*p) || *p == '_')) {
+            w += std::tolower((unsigned char)*p);
+            p++;
+        }
+        return w;
+    }
+
+    void skip_digits() {
+        peek();
+        while (p < e && std::isdigit((unsigned char)*p)) p++;
+    }
+
+    // Skips `(...)`, or `*8` and `*(...)` of a type declaration
+    void skip_type_params() {
+        if (peek() == '*') {
+            p++;
+            if (peek() != '(') {
+                skip_digits();
+                return;
+            }
+        }
+        if (peek() != '(') return;
+        int level = 0;
+        for (; p < e; p++) {
+            if (*p == '(') level++;
+            if (*p == ')' && --level == 0) {
+                p++;
+                return;
+            }
+        }
+    }
+};
+
+bool is_unit_prefix(const std::string &w) {
+    return w == "pure" || w == "impure" || w == "elemental"
+        || w == "recursive" || w == "non_recursive" || w == "module"
+        || w == "simple";
+}
+
+bool is_type_name(const std::string &w) {
+    return w == "integer" || w == "real" || w == "complex" || w == "logical"
+        || w == "character" || w == "doubleprecision" || w == "double"
+        || w == "type" || w == "class";
+}
+
+bool is_unit_keyword(const std::string &w) {
+    return w == "subroutine" || w == "function" || w == "module"
+        || w == "submodule" || w == "program" || w == "interface"
+        || w == "blockdata";
+}
+
+/* Classifies the line [b, e) of free-form source. Only the first statement
+ * of the line is looked at and only units whose end is recognized are
+ * reported, the rest (including `module procedure` bodies, which end with
+ * `end procedure`) is `Other`. Lines with several statements are never
+ * `UnitEnd`, so that a unit is not split after them.
+ */
+LineKind classify_line(const char *b, const char *e) {
+    LineScanner l(b, e);
+    if (l.at_end() || l.peek() == '#') return LineKind::Blank;
+    if (std::isdigit((unsigned char)l.peek())) l.skip_digits();
+    std::string w = l.word();
+    if (w.empty()) return LineKind::Other;
+    if (w.compare(0, 3, "end") == 0) {
+        std::string rest = w.substr(3);
+        if (rest.empty()) {
+            if (l.at_end()) return LineKind::UnitEnd;
+            rest = l.word();
+            if (rest == "block" && l.word() == "data") rest = "blockdata";
+        } else if (rest == "block" && l.word() == "data") {
+            rest = "blockdata";
+        }
+        if (!is_unit_keyword(rest)) return LineKind::Other;
+        // The optional name, or the generic spec of an interface
+        l.word();
+        l.skip_type_params();
+        return l.at_end() ? LineKind::UnitEnd : LineKind::Other;
+    }
+    if (w == "program") {
+        return l.at_name() ? LineKind::UnitStart : LineKind::Other;
+    }
+    if (w == "submodule") {
+        return l.peek() == '(' ? LineKind::UnitStart : LineKind::Other;
+    }
+    if (w == "abstract") {
+        return l.word() == "interface" ? LineKind::UnitStart : LineKind::Other;
+    }
+    if (w == "interface") {
+        return (l.at_end() || l.at_name()) ? LineKind::UnitStart
+            : LineKind::Other;
+    }
+    if (w == "blockdata") return LineKind::UnitStart;
+    if (w == "block") {
+        return l.word() == "data" ? LineKind::UnitStart : LineKind::Other;
+    }
+    if (w == "module") {
+        // `module name`
+        LineScanner l2 = l;
+        std::string name = l2.word();
+        if (!name.empty() && name != "procedure" && name != "subroutine"
+                && name != "function" && !is_unit_prefix(name)
+                && !is_type_name(name) && l2.at_end()) {
+            return LineKind::UnitStart;
+        }
+    }
+    // prefix* (subroutine | function) name
+    for (;;) {
+        if (w == "subroutine" || w == "function") {
+            return l.at_name() ? LineKind::UnitStart : LineKind::Other;
+        }
+        if (is_type_name(w)) {
+            if (w == "double" && l.word() != "precision") {
+                return LineKind::Other;
+            }
+            l.skip_type_params();
+        } else if (!is_unit_prefix(w)) {
+            return LineKind::Other;
+        }
+        w = l.word();
+    }
+}
+
+} // namespace
+
+std::vector<size_t> split_program_units(const std::string &s,
+    size_t n_chunks, size_t min_chunk_size)
+{
+    std::vector<size_t> splits;
+    if (n_chunks < 2 || s.size() < 2*min_chunk_size) return splits;
+    size_t target = std::max(s.size() / n_chunks, min_chunk_size);
+    size_t last = 0;
+    int depth = 0;
+    // A unit ended at depth 0; the next chunk starts at the next line that
+    // is not blank, because the parser attaches the blank and comment lines
+    // after a unit to it
+    bool unit_ended = false;
+    size_t pos = 0;
+    while (pos < s.size() && splits.size() + 1 < n_chunks) {
+        const char *b = s.data() + pos;
+        const char *e = (const char*)std::memchr(b, '\n', s.size() - pos);
+        if (e == nullptr) e = s.data() + s.size();
+        LineKind kind = classify_line(b, e);
+        if (kind != LineKind::Blank && unit_ended) {
+            unit_ended = false;
+            if (pos - last >= target && s.size() - pos >= min_chunk_size) {
+                splits.push_back(pos);
+                last = pos;
+            }
+        }
+        if (kind == LineKind::UnitStart) {
+            depth++;
+        } else if (kind == LineKind::UnitEnd) {
+            depth--;
+            // Unbalanced units (a main program without the `program` line,
+            // or unrecognized constructs): do not split at all
+            if (depth < 0) return {};
+            if (depth == 0) unit_ended = true;
+        }
+        pos = e - s.data() + 1;
+    }
+    return splits;
+}
+
+namespace {
+
+// Free-form sources smaller than this are not split for parsing in parallel
+const size_t parallel_parse_min_chunk = 16*1024;
+
+/* Parses the chunks of `s` returned by `split_program_units()` concurrently,
+ * each with its own Parser, Allocator and Diagnostics, and appends their
+ * items to `p.result` in the source order. The memory of the chunks is
+ * adopted by `p.m_a` and locations are relative to the whole `s`.
+ *
+ * Returns false without changing `p` if `s` is not split or if any chunk has
+ * an error; the caller then parses `s` as a whole, which reports the errors
+ * exactly as a sequential parse.
+ */
+bool parse_in_parallel(Parser &p, const std::string &s,
+    const CompilerOptions &co)
+{
+    std::vector<size_t> starts = split_program_units(s, co.parse_threads,
+        parallel_parse_min_chunk);
+    if (starts.empty()) return false;
+    starts.insert(starts.begin(), 0);
+    size_t n = starts.size();
+    // The chunks are tokenized in place in `s`
+    std::vector<std::string_view> chunks(n);
+    std::vector<std::unique_ptr<Allocator>> allocators(n);
+    std::vector<diag::Diagnostics> diagnostics(n);
+    std::vector<std::unique_ptr<Parser>> parsers(n);
+    std::vector<char> ok(n, false);
+    for (size_t i = 0; i < n; i++) {
+        size_t end = i+1 < n ? starts[i+1] : s.size();
+        chunks[i] = std::string_view(s).substr(starts[i], end - starts[i]);
+        allocators[i] = std::make_unique<Allocator>(
+            std::max<size_t>(1024*1024, 8*chunks[i].size()));
+        parsers[i] = std::make_unique<Parser>(*allocators[i], diagnostics[i],
+            false, co.continue_compilation);
+    }
+    auto parse_chunk = [&](size_t i) {
+        try {
+            trace::Scope trace_scope("Parse chunk");
+            ok[i] = parsers[i]->parse(chunks[i], starts[i])
+                && !diagnostics[i].has_error();
+        } catch (...) {
+            ok[i] = false;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < n; i++) threads.emplace_back(parse_chunk, i);
+    parse_chunk(0);
+    for (auto &t : threads) t.join();
+    for (size_t i = 0; i < n; i++) {
+        if (!ok[i]) return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < parsers[i]->result.size(); j++) {
+            p.result.push_back(p.m_a, parsers[i]->result[j]);
+        }
+        p.diag.diagnostics.insert(p.diag.diagnostics.end(),
+            diagnostics[i].diagnostics.begin(),
+            diagnostics[i].diagnostics.end());
+        p.m_a.adopt(*allocators[i]);
+    }
+    return true;
+}
+
+} // namespace
+
 Result<AST::TranslationUnit_t*> parse(Allocator &al, const std::string &s,
         diag::Diagnostics &diagnostics, const CompilerOptions &co)
 {
+    // The free-form tokenizer is driven by the parser and is part of this
+    // event, the fixed-form tokenizer has its own "Tokenize" event
+    trace::Scope trace_scope("Parse");
     Parser p(al, diagnostics, co.fixed_form, co.continue_compilation);
     try {
-        if (!p.parse(s)) {
+        bool parsed = co.parse_threads > 1 && !co.fixed_form
+            && !co.interactive && parse_in_parallel(p, s, co);
+        if (!parsed && !p.parse(s)) {
             if (!co.continue_compilation) {
                 return Error();
             }
@@ -255,16 +540,19 @@ Result<AST::TranslationUnit_t*> parse(Allocator &al, const std::string &s,
     return ast;
 }
 
-bool Parser::parse(const std::string &input)
+bool Parser::parse(std::string_view input, uint32_t offset)
 {
-    inp = input;
-    if (inp.size() > 0) {
-        if (inp[inp.size()-1] != '\n') inp.append("\n");
-    } else {
+    // The tokenizers need the input to end with a newline. The input is
+    // only copied if it does not, the (possibly very large) source is
+    // otherwise tokenized in place.
+    std::string_view src = input;
+    if (input.size() == 0 || input[input.size()-1] != '\n') {
+        inp = input;
         inp.append("\n");
+        src = inp;
     }
     if (!fixed_form) {
-        m_tokenizer.set_string(inp);
+        m_tokenizer.set_string(src, offset);
         try {
             if (yyparse(*this) == 0) {
                 if (diag.has_error())
@@ -275,8 +563,11 @@ bool Parser::parse(const std::string &input)
             return false;
         }
     } else {
-        f_tokenizer.set_string(inp);
-        if (!f_tokenizer.tokenize_input(diag, m_a, this->continue_compilation)) return false;
+        f_tokenizer.set_string(src);
+        {
+            trace::Scope trace_scope("Tokenize");
+            if (!f_tokenizer.tokenize_input(diag, m_a, this->continue_compilation)) return false;
+        }
         if (yyparse(*this) == 0) {
             if (diag.has_error())
                 return false;
@@ -667,6 +958,98 @@ bool is_include(const std::string &s, uint32_t pos) {
     }
 }
 
+#if defined(HAVE_PRESCAN_SSE2) || defined(HAVE_PRESCAN_AVX2)
+// Index of the lowest set bit, `mask` must not be 0
+inline int lowest_bit(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return i;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+/*
+ * Returns the position of the first byte at or after `pos` that the
+ * free-form prescanner has to process one by one: a newline, `&`, a quote or
+ * (if `bang` is true) `!`. Returns `s.size()` if there is none. All other
+ * bytes are copied to the output unchanged, so the prescanner appends the
+ * whole span up to the returned position at once.
+ *
+ * 32 (AVX2) or 16 (SSE2) bytes are compared at a time, the rest of the
+ * string (and other architectures) use a lookup table.
+ */
+size_t find_prescan_special(const std::string &s, size_t pos, bool bang)
+{
+    const char *p = s.data();
+    size_t n = s.size();
+    // Without `bang`, `!` is replaced by a duplicate of `\n`
+    const char c_bang = bang ? '!' : '\n';
+#ifdef HAVE_PRESCAN_AVX2
+    const __m256i nl32 = _mm256_set1_epi8('\n');
+    const __m256i amp32 = _mm256_set1_epi8('&');
+    const __m256i q32 = _mm256_set1_epi8('\'');
+    const __m256i dq32 = _mm256_set1_epi8('"');
+    const __m256i bang32 = _mm256_set1_epi8(c_bang);
+    while (pos + 32 <= n) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(p + pos));
+        __m256i m = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(x, nl32),
+                _mm256_cmpeq_epi8(x, amp32)),
+            _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(x, q32),
+                    _mm256_cmpeq_epi8(x, dq32)),
+                _mm256_cmpeq_epi8(x, bang32)));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(m);
+        if (mask) return pos + lowest_bit(mask);
+        pos += 32;
+    }
+#endif
+#ifdef HAVE_PRESCAN_SSE2
+    const __m128i nl16 = _mm_set1_epi8('\n');
+    const __m128i amp16 = _mm_set1_epi8('&');
+    const __m128i q16 = _mm_set1_epi8('\'');
+    const __m128i dq16 = _mm_set1_epi8('"');
+    const __m128i bang16 = _mm_set1_epi8(c_bang);
+    while (pos + 16 <= n) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(p + pos));
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(x, nl16), _mm_cmpeq_epi8(x, amp16)),
+            _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(x, q16), _mm_cmpeq_epi8(x, dq16)),
+                _mm_cmpeq_epi8(x, bang16)));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(m);
+        if (mask) return pos + lowest_bit(mask);
+        pos += 16;
+    }
+#endif
+    static const struct SpecialTable {
+        bool special[256];
+        SpecialTable() : special{} {
+            special[(unsigned char)'\n'] = true;
+            special[(unsigned char)'&'] = true;
+            special[(unsigned char)'\''] = true;
+            special[(unsigned char)'"'] = true;
+        }
+    } table;
+    while (pos < n) {
+        unsigned char c = p[pos];
+        if (table.special[c] || c == (unsigned char)c_bang) return pos;
+        pos++;
+    }
+    return n;
+}
+
+// Returns the position of the next newline at or after `pos`, or `s.size()`
+size_t find_newline(const std::string &s, size_t pos)
+{
+    if (pos >= s.size()) return s.size();
+    const void *nl = std::memchr(s.data() + pos, '\n', s.size() - pos);
+    return nl ? (const char*)nl - s.data() : s.size();
+}
+
 /*
 The prescan phase includes:
 - Removal of whitespace (fixed-form only)
@@ -794,7 +1177,18 @@ std::string prescan(const std::string &s, LocationManager &lm,
         // if `in_string` is true, keeps track of the quote
         // used for that string
         char quote = '\0';
+        out.reserve(s.size());
         while (pos < s.size()) {
+            if (!newline) {
+                // Copy the bytes that the loop below would copy unchanged.
+                // Inside a comment only a newline changes the state, inside
+                // a string `!` does not start a comment.
+                size_t end = in_comment ? find_newline(s, pos)
+                    : find_prescan_special(s, pos, !in_string);
+                out.append(s, pos, end - pos);
+                pos = end;
+                if (pos == s.size()) break;
+            }
             is_within_string(s, pos, quote, in_comment, in_string);
             if (newline && is_include(s, pos)) {
                 int col = 0; // doesn't matter
@@ -15,6 +15,7 @@ namespace LCompilers::LFortran {
 class Parser
 {
 public:
+    // Copy of the input if a newline had to be appended to it
     std::string inp;
 
 public:
@@ -31,7 +32,9 @@ public:
         result.reserve(al, 32);
     }
 
-    bool parse(const std::string &input);
+    // Parses `input`; `offset` is its position in the whole source if it is
+    // a part of it (see `Tokenizer::set_string()`)
+    bool parse(std::string_view input, uint32_t offset=0);
     void handle_yyerror(const Location &loc, const std::string &msg);
 };
 
@@ -41,6 +44,13 @@ Result<AST::TranslationUnit_t*> parse(Allocator &al,
     diag::Diagnostics &diagnostics,
     const CompilerOptions &co);
 
+// Returns the positions at which the free-form (prescanned) source `s` can
+// be split into at most `n_chunks` chunks of complete top-level program
+// units, used by `parse()` to parse the chunks in parallel. The positions are
+// the beginnings of lines, in increasing order.
+std::vector<size_t> split_program_units(const std::string &s,
+    size_t n_chunks, size_t min_chunk_size);
+
 // Tokenizes the `input` and return a list of tokens
 Result<std::vector<int>> tokens(Allocator &al, const std::string &input,
         diag::Diagnostics &diagnostics,
@@ -41,9 +41,18 @@ public:
 };
 
 std::string function_like_macro_expansion(
-            std::vector<std::string> &def_args,
-            std::string &expansion,
-            std::vector<std::string> &call_args);
+            const std::vector<std::string> &def_args,
+            const std::string &expansion,
+            const std::vector<std::string> &call_args);
+
+// Lookups of include files in the process wide cache of their preprocessed
+// output
+struct IncludeCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+IncludeCacheStats get_include_cache_stats();
 
 } // namespace LCompilers::LFortran
 
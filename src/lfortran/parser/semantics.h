@@ -14,6 +14,7 @@
 
 #include <lfortran/ast.h>
 #include <libasr/string_utils.h>
+#include <libasr/string_interner.h>
 #include <lfortran/parser/parser_exception.h>
 
 // This is only used in parser.tab.cc, nowhere else, so we simply include
@@ -65,6 +66,8 @@ static inline char* name2char(const ast_t *n)
 
 static inline bool streql(const char *s1, const char *s2)
 {
+    // Names are interned, the same name is the same pointer
+    if (s1 == s2) return true;
 #if defined(_MSC_VER)
     return _stricmp(s1, s2) == 0;
 #else
@@ -981,7 +984,9 @@ char *str2str_null(Allocator &al, const LCompilers::Str &s) {
     }
 }
 
-#define SYMBOL(x, l) make_Name_t(p.m_a, l, x.c_str(p.m_a), nullptr, 0)
+// Identifiers are interned, every occurrence of a name shares one copy
+#define SYMBOL(x, l) make_Name_t(p.m_a, l, \
+        LCompilers::intern(std::string_view(x.p, x.n)), nullptr, 0)
 // `x.int_n` is of type BigInt but we store the int64_t directly in AST
 #define INTEGER(x, l) make_Num_t(p.m_a, l, x.int_n.n, str2str_null(p.m_a, x.int_kind))
 #define INT1(l) make_Num_t(p.m_a, l, 1, nullptr)
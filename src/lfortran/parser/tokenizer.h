@@ -1,6 +1,8 @@
 #ifndef LFORTRAN_SRC_PARSER_TOKENIZER_H
 #define LFORTRAN_SRC_PARSER_TOKENIZER_H
 
+#include <string_view>
+
 #include <libasr/exception.h>
 #include <lfortran/parser/parser_stype.h>
 
@@ -14,6 +16,11 @@ public:
     unsigned char *cur_line;
     unsigned int line_num;
     unsigned char *string_start;
+    // Position of `string_start` in the whole source, added to all locations
+    uint32_t string_offset=0;
+    // End of the string to tokenize if it is a part of a larger source,
+    // `nullptr` if it ends with the null character of the source
+    unsigned char *string_end = nullptr;
     bool fixed_form=false;
 
     int last_token=-1;
@@ -25,8 +32,10 @@ public:
 
 public:
     // Set the string to tokenize. The caller must ensure `str` will stay valid
-    // as long as `lex` is being called.
-    void set_string(const std::string &str);
+    // as long as `lex` is being called. If `str` is a part of a larger source,
+    // `offset` is its position in it; `str` is then tokenized in place and
+    // must be followed by the rest of the null terminated source.
+    void set_string(std::string_view str, uint32_t offset=0);
 
     // Get next token. Token ID is returned as function result, the semantic
     // value is put into `yylval`.
@@ -57,8 +66,8 @@ public:
     // Return the current token's location
     void token_loc(Location &loc) const
     {
-        loc.first = tok-string_start;
-        loc.last = cur-string_start-1;
+        loc.first = tok-string_start+string_offset;
+        loc.last = cur-string_start+string_offset-1;
     }
     void add_rel_warning(diag::Diagnostics &diagnostics, bool fixed_form, int rel_token) const;
 };
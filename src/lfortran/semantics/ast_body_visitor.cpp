@@ -2151,7 +2151,7 @@ public:
     void remove_common_variable_declarations(SymbolTable* current_scope) {
         // iterate over all symbols in symbol table and check if any of them is present in common_variables_hash
         // if yes, then remove it from scope
-        std::map<std::string, ASR::symbol_t*> syms = current_scope->get_scope();
+        auto syms = current_scope->get_scope();
         for (auto it = syms.begin(); it != syms.end(); ++it) {
             if (ASR::is_a<ASR::Variable_t>(*(it->second))) {
                 ASR::Variable_t* var = ASR::down_cast<ASR::Variable_t>(it->second);
@@ -2197,7 +2197,7 @@ public:
         }
 
         create_and_replace_structType();
-        ASRUtils::update_call_args(al, current_scope, compiler_options.implicit_interface, changed_external_function_symbol);
+        update_call_args();
 
         starting_m_body = nullptr;
         starting_n_body =  0;
@@ -2630,7 +2630,7 @@ public:
         }
 
         create_and_replace_structType();
-        ASRUtils::update_call_args(al, current_scope, compiler_options.implicit_interface, changed_external_function_symbol);
+        update_call_args();
 
         starting_m_body = nullptr;
         starting_n_body = 0;
@@ -2710,7 +2710,7 @@ public:
         }
 
         create_and_replace_structType();
-        ASRUtils::update_call_args(al, current_scope, compiler_options.implicit_interface, changed_external_function_symbol);
+        update_call_args();
 
         starting_m_body = nullptr;
         starting_n_body = 0;
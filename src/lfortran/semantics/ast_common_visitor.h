@@ -1368,6 +1368,9 @@ public:
     // mapping of hash int's of scope to 'explicit_intrinsic_procedures'
     std::map<uint64_t, std::vector<std::string>> &explicit_intrinsic_procedures_mapping;
     std::map<std::string, ASR::symbol_t*> changed_external_function_symbol;
+    // `changed_external_function_symbol` at the end of the last
+    // `update_call_args()`
+    std::map<std::string, ASR::symbol_t*> call_args_updated_for;
     std::map<std::string, std::vector<AST::stmt_t*>> entry_point_mapping;
     std::vector<std::string> external_procedures;
 
@@ -4693,6 +4696,26 @@ public:
         return 1; // default
     }
 
+    // Updates the arguments of calls that refer to replaced symbols, see
+    // `ASRUtils::update_call_args()`. Only the procedures whose symbol tables
+    // changed since the last call are visited (the whole translation unit if
+    // an external function changed or a symbol outside of procedures was
+    // replaced): otherwise semantics is quadratic in the number of
+    // procedures.
+    void update_call_args() {
+        if (!compiler_options.implicit_interface) return;
+        bool external_functions_changed
+            = changed_external_function_symbol != call_args_updated_for;
+        if (!external_functions_changed
+                && !current_scope->get_global_scope()->has_changes()) {
+            return;
+        }
+        ASRUtils::update_call_args(al, current_scope,
+            compiler_options.implicit_interface, changed_external_function_symbol,
+            external_functions_changed);
+        call_args_updated_for = changed_external_function_symbol;
+    }
+
     void create_and_replace_structType() {
 
         class StructTypeVisitor : public ASR::BaseWalkVisitor<StructTypeVisitor> {
@@ -8403,7 +8426,7 @@ public:
                 if (v && is_external_procedure) {
                     erase_from_external_mapping(var_name);
                 }
-                ASRUtils::update_call_args(al, current_scope, compiler_options.implicit_interface, changed_external_function_symbol);
+                update_call_args();
             }
         }
         // if v is a function which has null pointer return type, give error
@@ -8452,7 +8475,7 @@ public:
                 // Which is a function call.
                 // We remove "x" from the symbol table and instead recreate it.
                 // We use the type of the old "x" as the return value type.
-                std::map<std::string, ASR::symbol_t*> scope_ = current_scope->get_scope();
+                auto scope_ = current_scope->get_scope();
                 bool in_current_scope = (scope_.find(var_name) != scope_.end());
                 SymbolTable* sym_scope = current_scope;
                 if (in_current_scope) {
@@ -8478,7 +8501,7 @@ public:
 
                 // erase from external_procedures_mapping
                 erase_from_external_mapping(var_name);
-                ASRUtils::update_call_args(al, current_scope, compiler_options.implicit_interface, changed_external_function_symbol);
+                update_call_args();
 
                 // Update arguments if the symbol belonged to a function
                 if (current_scope->asr_owner) {
@@ -8507,7 +8530,7 @@ public:
             if (ASR::is_a<ASR::Function_t>(*v2)) {
                 current_scope->erase_symbol(var_name);
                 erase_from_external_mapping(var_name);
-                ASRUtils::update_call_args(al, current_scope, compiler_options.implicit_interface, changed_external_function_symbol);
+                update_call_args();
                 v = v2;
             }
         }
@@ -102,6 +102,9 @@ Result<ASR::TranslationUnit_t*> ast_to_asr(Allocator &al,
     };
 #endif
     if (!symtab_only) {
+        // Records the symbol tables that the body visitor changes, so that
+        // `update_call_args()` only visits their procedures
+        ChangedScopesTracker changed_scopes(tu->m_symtab->get_global_scope());
         auto res = body_visitor(
             al, ast, diagnostics, unit, compiler_options,
             implicit_mapping, common_variables_hash, external_procedures_mapping,
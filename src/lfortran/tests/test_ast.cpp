@@ -13,6 +13,10 @@
 #include <lfortran/semantics/ast_to_asr.h>
 #include <libasr/asr_verify.h>
 #include <libasr/utils.h>
+#include <libasr/pickle.h>
+#include <libasr/serialization.h>
+#include <libasr/pass/pass_manager.h>
+#include <lfortran/compilation_cache.h>
 
 namespace LCompilers::LFortran {
 
@@ -147,5 +151,432 @@ end program
     }
 }
 
+// Compiles `src` as "input.f90" to ASR and applies the comma separated list of
+// `passes` (none if it is empty)
+ASR::TranslationUnit_t* asr_after_passes(Allocator &al, const std::string &src,
+        const std::string &passes, CompilerOptions &compiler_options,
+        LCompilers::LocationManager &lm) {
+    LCompilers::diag::Diagnostics diagnostics;
+    {
+        LCompilers::LocationManager::FileLocations fl;
+        fl.in_filename = "input.f90";
+        lm.files.push_back(fl);
+    }
+    FortranEvaluator e(compiler_options);
+    AST::TranslationUnit_t* ast = TRY(e.get_ast2(src, lm, diagnostics));
+    ASR::TranslationUnit_t* asr = TRY(LFortran::ast_to_asr(al, *ast,
+        diagnostics, nullptr, false, compiler_options, lm));
+    if (!passes.empty()) {
+        LCompilers::PassManager lpm;
+        std::string pass_list = passes, skip_passes = "";
+        lpm.parse_pass_arg(pass_list, skip_passes);
+        lpm.apply_passes(al, asr, compiler_options.po, diagnostics);
+        CHECK(asr_verify(*asr, true, diagnostics));
+    }
+    return asr;
+}
+
+ASR::TranslationUnit_t* asr_after_passes(Allocator &al, const std::string &src,
+        const std::string &passes, CompilerOptions &compiler_options) {
+    LCompilers::LocationManager lm;
+    return asr_after_passes(al, src, passes, compiler_options, lm);
+}
+
+TEST_CASE("Procedure passes on threads") {
+    std::string src = R"""(
+module loops
+implicit none
+contains
+)""";
+    for (int i = 0; i < 20; i++) {
+        src += "subroutine s" + std::to_string(i) + R"""((a, b)
+real, intent(inout) :: a(:), b(:)
+integer :: i, j
+do i = 1, size(a)
+    do j = 1, 2
+        a(i) = a(i) + j
+    end do
+end do
+where (a > 0) b = a
+forall (i = 1:size(b)) b(i) = 2*b(i)
+end subroutine
+)""";
+    }
+    src += R"""(
+end module
+
+program main
+use loops
+real :: x(3), y(3)
+integer :: k
+do k = 1, 3
+    x(k) = k
+end do
+call s0(x, y)
+end program
+)""";
+
+    // Applying the passes on one or on four threads gives the same ASR
+    std::vector<std::string> results;
+    for (int threads : {1, 4}) {
+        Allocator al(64*1024);
+        CompilerOptions compiler_options;
+        compiler_options.po.pass_threads = threads;
+        LCompilers::SymbolTable::reset_global_counter();
+        ASR::TranslationUnit_t* asr = asr_after_passes(al, src,
+            "forall,where,do_loops", compiler_options);
+        results.push_back(LCompilers::pickle(*asr));
+    }
+    CHECK(results[0].find("(DoLoop") == std::string::npos);
+    CHECK(results[0].find("(Where") == std::string::npos);
+    CHECK(results[0] == results[1]);
+}
+
+TEST_CASE("Loop fusion") {
+    std::string src = R"""(
+program fusion
+implicit none
+real :: a(10), b(10), c(10), d(10), e(10)
+b = 1
+c = 2
+e = 3
+a = b + c
+d = a * e
+print *, d
+end program
+)""";
+    Allocator al(64*1024);
+    CompilerOptions compiler_options;
+    ASR::TranslationUnit_t* asr = asr_after_passes(al, src,
+        "array_op,loop_fusion", compiler_options);
+
+    // The five loops are fused into one, and the arrays that are only used
+    // inside of it are replaced by scalars
+    std::string s = LCompilers::pickle(*asr);
+    size_t first = s.find("(DoLoop");
+    CHECK(first != std::string::npos);
+    CHECK(s.find("(DoLoop", first + 1) == std::string::npos);
+    ASR::Program_t *prog = ASR::down_cast<ASR::Program_t>(
+        asr->m_symtab->get_symbol("fusion"));
+    CHECK(prog->m_symtab->get_symbol("a") == nullptr);
+    CHECK(prog->m_symtab->get_symbol("b") == nullptr);
+    CHECK(prog->m_symtab->get_symbol("d") != nullptr);
+
+    // A loop written by the user is fused if it has the same number of
+    // iterations, `i` is incremented in the fused loop
+    auto n_loops = [&](const std::string &user_loop) {
+        std::string s = LCompilers::pickle(*asr_after_passes(al, R"""(
+program fusion
+implicit none
+real :: a(10), b(10), c(10)
+integer :: i
+b = 1
+a = b + 1
+)""" + user_loop + R"""(
+    c(i) = a(i)
+end do
+print *, c, i
+end program
+)""", "array_op,loop_fusion", compiler_options));
+        size_t n = 0;
+        for (size_t pos = s.find("(DoLoop"); pos != std::string::npos;
+                pos = s.find("(DoLoop", pos + 1)) {
+            n++;
+        }
+        return n;
+    };
+    CHECK(n_loops("do i = 1, 10") == 1);
+    CHECK(n_loops("do i = 1, 9") == 2);
+}
+
+TEST_CASE("Loop tiling") {
+    // The loop variables of the first loop nest after the `loop_tile` pass
+    auto loop_nest = [](const std::string &src) {
+        Allocator al(64*1024);
+        CompilerOptions compiler_options;
+        ASR::TranslationUnit_t* asr = asr_after_passes(al, src, "loop_tile",
+            compiler_options);
+        ASR::Program_t *prog = ASR::down_cast<ASR::Program_t>(
+            asr->m_symtab->get_symbol("tile"));
+        std::vector<std::string> vars;
+        ASR::stmt_t *s = prog->m_body[0];
+        while (ASR::is_a<ASR::DoLoop_t>(*s)) {
+            ASR::DoLoop_t *loop = ASR::down_cast<ASR::DoLoop_t>(s);
+            vars.push_back(ASRUtils::symbol_name(
+                ASR::down_cast<ASR::Var_t>(loop->m_head.m_v)->m_v));
+            s = loop->m_body[0];
+        }
+        return vars;
+    };
+
+    // Matrix multiply: interchanged so that `i` is innermost, and tiled
+    std::vector<std::string> vars = loop_nest(R"""(
+program tile
+implicit none
+real :: a(100,100), b(100,100), c(100,100)
+integer :: i, j, k
+do i = 1, 100
+    do j = 1, 100
+        do k = 1, 100
+            c(i,j) = c(i,j) + a(i,k) * b(k,j)
+        end do
+    end do
+end do
+end program
+)""");
+    REQUIRE(vars.size() == 6);
+    CHECK(vars[0] == "__libasr_tile_j");
+    CHECK(vars[2] == "__libasr_tile_i");
+    CHECK(vars[3] == "j");
+    CHECK(vars[4] == "k");
+    CHECK(vars[5] == "i");
+
+    // Each iteration reads the element written by the previous one
+    vars = loop_nest(R"""(
+program tile
+implicit none
+real :: a(100,100)
+integer :: i, j
+do i = 2, 100
+    do j = 1, 100
+        a(i,j) = a(i-1,j) + 1
+    end do
+end do
+end program
+)""");
+    CHECK(vars == std::vector<std::string>({"i", "j"}));
+
+    // Elementwise: no element is reused, the loops are only interchanged
+    vars = loop_nest(R"""(
+program tile
+implicit none
+real :: a(100,100), b(100,100), c(100,100)
+integer :: i, j
+do i = 1, 100
+    do j = 1, 100
+        c(i,j) = a(i,j) + b(i,j)
+    end do
+end do
+end program
+)""");
+    CHECK(vars == std::vector<std::string>({"j", "i"}));
+}
+
+TEST_CASE("MatMul kernel") {
+    // The C functions called by the first statement after the
+    // `matmul_kernel` pass, outermost first
+    auto kernels = [](const std::string &src, const std::string &blas) {
+        Allocator al(64*1024);
+        CompilerOptions compiler_options;
+        compiler_options.po.blas = blas;
+        ASR::TranslationUnit_t* asr = asr_after_passes(al, src,
+            "matmul_kernel", compiler_options);
+        ASR::Program_t *prog = ASR::down_cast<ASR::Program_t>(
+            asr->m_symtab->get_symbol("mm"));
+        std::vector<std::string> names;
+        ASR::stmt_t *s = prog->m_body[0];
+        if (ASR::is_a<ASR::If_t>(*s)) {
+            // The original assignment is kept for the other cases
+            ASR::If_t *if_ = ASR::down_cast<ASR::If_t>(s);
+            REQUIRE(if_->n_orelse == 1);
+            CHECK(ASR::is_a<ASR::Assignment_t>(*if_->m_orelse[0]));
+        }
+        while (ASR::is_a<ASR::If_t>(*s)) {
+            s = ASR::down_cast<ASR::If_t>(s)->m_body[0];
+            if (ASR::is_a<ASR::SubroutineCall_t>(*s)) {
+                ASR::Function_t *f = ASR::down_cast<ASR::Function_t>(
+                    ASR::down_cast<ASR::SubroutineCall_t>(s)->m_name);
+                names.push_back(ASRUtils::get_FunctionType(f)->m_bindc_name);
+            }
+        }
+        return names;
+    };
+
+    std::string src = R"""(
+program mm
+implicit none
+real(8) :: a(4,3), b(3,5), c(4,5)
+c = matmul(a, b)
+end program
+)""";
+    CHECK(kernels(src, "") == std::vector<std::string>({"_lfortran_dgemm"}));
+    CHECK(kernels(src, "openblas")
+        == std::vector<std::string>({"cblas_dgemm"}));
+
+    // Mixed kinds are left to the `intrinsic_function` pass
+    CHECK(kernels(R"""(
+program mm
+implicit none
+real(4) :: a(4,3), c(4,5)
+real(8) :: b(3,5)
+c = matmul(a, b)
+end program
+)""", "").empty());
+}
+
+TEST_CASE("Structural hash") {
+    // Hashes of the module, of its procedure `f` and of the module with the
+    // locations of its code
+    auto hashes = [](const std::string &src) {
+        Allocator al(64*1024);
+        CompilerOptions compiler_options;
+        LCompilers::LocationManager lm;
+        ASR::TranslationUnit_t* asr = asr_after_passes(al, src, "",
+            compiler_options, lm);
+        ASR::Module_t *m = ASR::down_cast<ASR::Module_t>(
+            asr->m_symtab->get_symbol("m"));
+        return std::vector<uint64_t>({
+            LCompilers::structural_hash((ASR::asr_t&)*asr),
+            LCompilers::structural_hash(
+                (ASR::asr_t&)*m->m_symtab->get_symbol("f")),
+            LCompilers::structural_hash((ASR::asr_t&)*asr, &lm)});
+    };
+    auto h1 = hashes(R"""(
+module m
+contains
+integer function f(x)
+integer, intent(in) :: x
+f = 2*x
+end function
+integer function g(x)
+integer, intent(in) :: x
+g = f(x) + 1
+end function
+end module
+)""");
+    // Only comments, formatting and line numbers changed
+    auto h2 = hashes(R"""(
+! The module
+module m
+
+contains
+
+    ! Doubles x
+    integer function f(x)
+        integer, intent(in) :: x
+        f = 2 * x
+    end function
+
+    integer function g(x)
+        integer, intent(in) :: x
+        g = f(x) + 1
+    end function
+
+end module
+)""");
+    // The code of `g` changed
+    auto h3 = hashes(R"""(
+module m
+contains
+integer function f(x)
+integer, intent(in) :: x
+f = 2*x
+end function
+integer function g(x)
+integer, intent(in) :: x
+g = f(x) + 2
+end function
+end module
+)""");
+    // Only a comment changed, the code stays on the same lines and columns
+    auto h4 = hashes(R"""(
+module m
+contains
+integer function f(x) ! doubles x
+integer, intent(in) :: x
+f = 2*x
+end function
+integer function g(x)
+integer, intent(in) :: x
+g = f(x) + 1 ! one more
+end function
+end module
+)""");
+    CHECK(h1[0] == h2[0]);
+    CHECK(h1[1] == h2[1]);
+    CHECK(h1[0] != h3[0]);
+    CHECK(h1[1] == h3[1]);
+    CHECK(h1[0] == h4[0]);
+    // With the locations, moving code to other lines changes the hash
+    CHECK(h1[2] != h2[2]);
+    CHECK(h1[2] == h4[2]);
+}
+
+TEST_CASE("Compilation cache key") {
+    std::string src = R"""(
+program p
+print *, 1
+end program
+)""";
+    CompilationCache cache("cache");
+    auto key = [&](std::string passes, std::string skip_passes) {
+        CompilerOptions compiler_options;
+        LCompilers::PassManager lpm;
+        lpm.use_default_passes();
+        lpm.parse_pass_arg(passes, skip_passes);
+        return cache.get_key("input.f90", src, compiler_options, lpm, false);
+    };
+    CHECK(key("", "") == key("", ""));
+    // Compilations that only differ by --pass or --skip-pass
+    CHECK(key("", "") != key("", "loop_tile"));
+    CHECK(key("", "loop_tile") != key("", "loop_fusion"));
+    CHECK(key("", "") != key("do_loops", ""));
+}
+
+TEST_CASE("Update call args") {
+    std::string src = R"""(
+module m
+contains
+subroutine f(x)
+integer, intent(in) :: x
+print *, x
+end subroutine
+subroutine g(y)
+integer, intent(in) :: y
+call f(y)
+end subroutine
+end module
+)""";
+    Allocator al(64*1024);
+    CompilerOptions compiler_options;
+    compiler_options.implicit_interface = true;
+    ASR::TranslationUnit_t* asr = asr_after_passes(al, src, "",
+        compiler_options);
+    SymbolTable *module_scope = ASR::down_cast<ASR::Module_t>(
+        asr->m_symtab->get_symbol("m"))->m_symtab;
+    ASR::Function_t *f = ASR::down_cast<ASR::Function_t>(
+        module_scope->get_symbol("f"));
+    std::map<std::string, ASR::symbol_t*> changed_external_function_symbol;
+    auto update_call_args = [&]() {
+        return ASRUtils::update_call_args(al, asr->m_symtab, true,
+            changed_external_function_symbol, false);
+    };
+    {
+        ChangedScopesTracker tracker(asr->m_symtab);
+        update_call_args();
+        CHECK(!asr->m_symtab->has_changes());
+        // Nothing changed since the last walk: no procedure is visited
+        CHECK(update_call_args() == 0);
+        // Added symbols do not make stale references
+        f->m_symtab->add_symbol("t", f->m_symtab->get_symbol("x"));
+        CHECK(asr->m_symtab->get_changed_scopes().size() == 1);
+        CHECK(update_call_args() == 0);
+        // A replaced local variable is only referenced from its procedure
+        f->m_symtab->overwrite_symbol("x", f->m_symtab->get_symbol("x"));
+        CHECK(update_call_args() == 1);
+        CHECK(!asr->m_symtab->has_changes());
+        CHECK(!f->m_symtab->symbols_replaced);
+        // A replaced module symbol can be referenced from everywhere
+        module_scope->overwrite_symbol("f", module_scope->get_symbol("f"));
+        CHECK(update_call_args() == 2);
+        CHECK(update_call_args() == 0);
+    }
+
+    // Without a list the changes are not recorded: everything is visited
+    f->m_symtab->overwrite_symbol("x", f->m_symtab->get_symbol("x"));
+    CHECK(asr->m_symtab->get_changed_scopes().empty());
+    CHECK(asr->m_symtab->has_changes());
+    CHECK(update_call_args() == 2);
+}
 
 } // namespace LCompilers::LFortran
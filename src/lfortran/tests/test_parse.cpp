@@ -2,12 +2,20 @@
 
 #include <iostream>
 #include <sstream>
+#include <fstream>
 #include <chrono>
 #include <string>
+#include <filesystem>
 
 #include <lfortran/parser/parser.h>
 #include <lfortran/parser/parser.tab.hh>
+#include <lfortran/parser/preprocessor.h>
+#include <lfortran/pickle.h>
+#include <lfortran/module_dependencies.h>
 #include <libasr/bigint.h>
+#include <libasr/asr_scopes.h>
+#include <libasr/trace.h>
+#include <libasr/string_interner.h>
 
 using LCompilers::LFortran::parse;
 using LCompilers::TRY;
@@ -368,6 +376,94 @@ TEST_CASE("Test LCompilers::Str") {
     CHECK(copy[2] == '\x00');
 }
 
+TEST_CASE("String interner") {
+    size_t n = LCompilers::interned_count();
+    std::string name = "test_parse_interned_name";
+    char *a = LCompilers::intern(name);
+    char *b = LCompilers::intern(std::string_view("test_parse_interned_name_2", name.size()));
+    CHECK(a == b);
+    CHECK(a != name.c_str());
+    CHECK(std::string(a) == name);
+    CHECK(LCompilers::intern("test_parse_interned_name_2") != a);
+    CHECK(LCompilers::interned_count() == n + 2);
+    CHECK(LCompilers::intern_eq(a, b));
+    CHECK(LCompilers::intern_eq(a, name.c_str()));
+    CHECK(!LCompilers::intern_eq(a, "x"));
+
+    // Every occurrence of a name in the AST shares the interned copy
+    Allocator al(4*1024);
+    LCompilers::diag::Diagnostics diagnostics;
+    LCompilers::CompilerOptions co;
+    co.interactive = true;
+    auto result = TRY(parse(al, "x = x + y", diagnostics, co))->m_items[0];
+    std::vector<char*> ids;
+    class NameVisitor : public BaseWalkVisitor<NameVisitor> {
+    public:
+        std::vector<char*> &ids;
+        NameVisitor(std::vector<char*> &ids) : ids{ids} {}
+        void visit_Name(const Name_t &x) {
+            ids.push_back(x.m_id);
+        }
+    };
+    NameVisitor v(ids);
+    v.visit_ast(*result);
+    REQUIRE(ids.size() == 3);
+    CHECK(ids[0] == ids[1]);
+    CHECK(ids[0] == LCompilers::intern("x"));
+    CHECK(ids[2] == LCompilers::intern("y"));
+
+    // Between the requests of a server, once the AST is not used anymore
+    LCompilers::clear_interned();
+    CHECK(LCompilers::interned_count() == 0);
+    CHECK(LCompilers::interned_bytes() == 0);
+    CHECK(std::string(LCompilers::intern(name)) == name);
+    CHECK(LCompilers::interned_count() == 1);
+}
+
+TEST_CASE("Test LCompilers::SymbolTable") {
+    using LCompilers::ASR::symbol_t;
+    auto sym = [](size_t i) { return reinterpret_cast<symbol_t*>((i + 1) * 8); };
+    LCompilers::SymbolTable global(nullptr);
+    LCompilers::SymbolTable local(&global);
+    int N = 1000;
+    for (int i = 0; i < N; i++) {
+        global.add_symbol("s" + std::to_string(i), sym(i));
+    }
+    local.add_symbol("s1", sym(N));
+    // Erasing shifts back the following entries of the probe sequences
+    for (int i = 0; i < N; i += 2) {
+        global.erase_symbol("s" + std::to_string(i));
+    }
+    for (int i = 0; i < N; i++) {
+        std::string name = "s" + std::to_string(i);
+        if (i % 2 == 0) {
+            CHECK(global.get_symbol(name) == nullptr);
+        } else {
+            CHECK(global.get_symbol(name) == sym(i));
+        }
+    }
+    CHECK(global.get_scope().size() == (size_t)N / 2);
+    CHECK(local.resolve_symbol("s1") == sym(N));
+    CHECK(local.resolve_symbol("s3") == sym(3));
+    CHECK(local.resolve_symbol("s4") == nullptr);
+    CHECK(local.get_symbol("s3") == nullptr);
+
+    global.overwrite_symbol("s3", sym(N + 1));
+    CHECK(local.resolve_symbol("s3") == sym(N + 1));
+    global.add_or_overwrite_symbol("s4", sym(4));
+    global.add_or_overwrite_symbol("s5", sym(N + 2));
+    CHECK(global.get_symbol("s4") == sym(4));
+    CHECK(global.get_symbol("s5") == sym(N + 2));
+
+    // Iteration is in the sorted order of the names
+    std::string prev;
+    for (auto &item : global.get_scope()) {
+        CHECK(prev < item.first);
+        CHECK(global.get_symbol(item.first) == item.second);
+        prev = item.first;
+    }
+}
+
 TEST_CASE("Test LFortran::Allocator") {
     Allocator al(32);
     // Size is what we asked (32) plus alignment (8) = 40
@@ -407,6 +503,282 @@ TEST_CASE("Test LFortran::Allocator 2") {
     v->~vector<int>();
 }
 
+TEST_CASE("Test LFortran::Allocator mark/release") {
+    Allocator al(32);
+    al.alloc(5);
+    AllocatorStats s = al.stats();
+    CHECK(s.bytes_requested == 5);
+    CHECK(s.bytes_allocated == 8);
+    CHECK(s.bytes_alignment == 3);
+    CHECK(s.num_chunks == 1);
+
+    Allocator::Mark m = al.mark();
+    for (size_t i = 0; i < 100; i++) al.alloc(30);
+    s = al.stats();
+    CHECK(s.bytes_requested == 5 + 100*30);
+    CHECK(s.bytes_allocated == 8 + 100*32);
+    size_t num_chunks = s.num_chunks;
+    CHECK(num_chunks > 1);
+
+    // Everything after the mark is freed, the chunks are kept for reuse
+    al.release(m);
+    s = al.stats();
+    CHECK(s.bytes_requested == 5);
+    CHECK(s.bytes_allocated == 8);
+    CHECK(s.num_chunks == 1);
+    CHECK(s.bytes_free > 0);
+    CHECK(s.peak_bytes_allocated == 8 + 100*32);
+
+    // The same allocations reuse the retired chunks
+    for (size_t i = 0; i < 100; i++) al.alloc(30);
+    s = al.stats();
+    CHECK(s.num_chunks == num_chunks);
+    CHECK(s.bytes_free == 0);
+
+    {
+        AllocatorScope scope(al);
+        al.alloc(100000);
+        CHECK(al.stats().bytes_allocated == 8 + 100*32 + 100000);
+    }
+    CHECK(al.stats().bytes_allocated == 8 + 100*32);
+
+    al.reset();
+    s = al.stats();
+    CHECK(s.bytes_allocated == 0);
+    CHECK(s.num_chunks == 1);
+    al.release_free_blocks();
+    CHECK(al.stats().bytes_free == 0);
+}
+
+TEST_CASE("Test LFortran::Allocator adopt") {
+    Allocator al(1024);
+    al.alloc(5);
+    int *x;
+    {
+        Allocator al2(64);
+        x = al2.allocate<int>(100);
+        for (int i = 0; i < 100; i++) x[i] = i;
+        al.adopt(al2);
+    }
+    // The memory of `al2` is now owned by `al`
+    CHECK(x[99] == 99);
+    AllocatorStats s = al.stats();
+    CHECK(s.bytes_requested == 5 + 400);
+    CHECK(s.bytes_allocated == 8 + 400);
+    CHECK(s.num_chunks == 3);
+
+    // Adopted memory is not released
+    al.reset();
+    CHECK(al.stats().bytes_allocated == 400);
+    CHECK(x[0] == 0);
+}
+
+TEST_CASE("Test LFortran::Allocator keep") {
+    Allocator al(1024);
+    std::shared_ptr<int> a = std::make_shared<int>(1);
+    std::shared_ptr<int> b = std::make_shared<int>(2);
+    std::shared_ptr<int> c = std::make_shared<int>(3);
+    al.keep(a);
+    Allocator::Mark m = al.mark();
+    al.keep(b);
+    {
+        Allocator al2(64);
+        al2.keep(c);
+        al.adopt(al2);
+    }
+    CHECK(a.use_count() == 2);
+    CHECK(b.use_count() == 2);
+    CHECK(c.use_count() == 2);
+
+    // The objects kept after the mark are dropped, adopted ones are not
+    al.release(m);
+    CHECK(a.use_count() == 2);
+    CHECK(b.use_count() == 1);
+    CHECK(c.use_count() == 2);
+    al.reset();
+    CHECK(a.use_count() == 1);
+    CHECK(c.use_count() == 2);
+}
+
+TEST_CASE("Memory report") {
+    Allocator al(1024);
+    LCompilers::PassOptions po;
+    LCompilers::record_memory_usage(po, "Parser", al);
+    CHECK(po.vector_of_memory_report.size() == 0);
+
+    po.memory_report = true;
+    al.alloc(100);
+    LCompilers::record_memory_usage(po, "Parser", al);
+    al.alloc(200);
+    LCompilers::record_memory_usage(po, "[PASS]do_loops", al);
+    REQUIRE(po.vector_of_memory_report.size() == 2);
+    CHECK(po.vector_of_memory_report[0].allocator_bytes == 104);
+    CHECK(po.vector_of_memory_report[1].allocator_bytes == 304);
+#if defined(__linux__) || defined(__APPLE__) || defined(_WIN32)
+    CHECK(po.vector_of_memory_report[0].peak_rss > 0);
+#endif
+    CHECK(po.vector_of_memory_report[1].peak_rss
+        >= po.vector_of_memory_report[0].peak_rss);
+
+    po.vector_of_memory_report[0].file = "a \"b\"\t\x01.f90";
+    std::string json = LCompilers::memory_report_to_json(
+        po.vector_of_memory_report);
+    CHECK(json.find("\"file\": \"a \\\"b\\\"\\t\\u0001.f90\"")
+        != std::string::npos);
+    CHECK(json.find("\"phase\": \"[PASS]do_loops\"") != std::string::npos);
+    CHECK(json.find("\"allocator_bytes\": 304") != std::string::npos);
+    std::string text = LCompilers::memory_report_to_text(
+        po.vector_of_memory_report);
+    CHECK(text.find("[PASS]do_loops") != std::string::npos);
+}
+
+TEST_CASE("Trace") {
+    std::string filename = "test_parse_trace.json";
+    CHECK(!LCompilers::trace::enabled());
+    // Without an open trace file nothing is written
+    LCompilers::trace::begin("Parse");
+    LCompilers::trace::end("Parse");
+
+    REQUIRE(LCompilers::trace::open(filename));
+    CHECK(LCompilers::trace::enabled());
+    LCompilers::trace::set_file("a.f90");
+    {
+        LCompilers::trace::Scope scope("Parse");
+    }
+    // The end event is also written if the phase throws
+    LCompilers::trace::set_file("b\x01.f90");
+    try {
+        LCompilers::trace::Scope scope("[PASS]fail");
+        throw LCompilers::LCompilersException("fail");
+    } catch (const LCompilers::LCompilersException &) {
+    }
+    LCompilers::trace::close();
+    CHECK(!LCompilers::trace::enabled());
+    LCompilers::trace::set_file("");
+
+    std::string text;
+    REQUIRE(LCompilers::read_file(filename, text));
+    std::filesystem::remove(filename);
+    CHECK(LCompilers::startswith(text, "[\n"));
+    size_t b = text.find("\"name\": \"Parse\", \"cat\": \"lfortran\", \"ph\": \"B\"");
+    size_t e = text.find("\"name\": \"Parse\", \"cat\": \"lfortran\", \"ph\": \"E\"");
+    CHECK(b != std::string::npos);
+    CHECK(e != std::string::npos);
+    CHECK(b < e);
+    CHECK(text.find("\"args\": {\"file\": \"a.f90\"}},\n") != std::string::npos);
+    CHECK(text.find("\"name\": \"[PASS]fail\", \"cat\": \"lfortran\", \"ph\": \"E\"")
+        != std::string::npos);
+    CHECK(text.find("\"args\": {\"file\": \"b\\u0001.f90\"}},\n")
+        != std::string::npos);
+}
+
+TEST_CASE("C preprocessor include cache") {
+    std::string header = "test_parse_cpp_header.h";
+    {
+        std::ofstream out(header);
+        out << "#define N 3\n#ifdef DP\nreal(8) :: x(N)\n#else\nreal :: x(N)\n#endif\n";
+    }
+    auto preprocess = [&](const std::string &src,
+            std::vector<std::string> defines) {
+        LCompilers::CompilerOptions co;
+        co.c_preprocessor_defines = defines;
+        LCompilers::LFortran::CPreprocessor cpp(co);
+        LCompilers::LocationManager lm;
+        {
+            LCompilers::LocationManager::FileLocations fl;
+            fl.in_filename = "test_parse_cpp.f90";
+            lm.files.push_back(fl);
+        }
+        LCompilers::diag::Diagnostics diagnostics;
+        auto res = cpp.run(src, lm, cpp.macro_definitions, diagnostics);
+        REQUIRE(res.ok);
+        CHECK(cpp.macro_definitions.find("N") != cpp.macro_definitions.end());
+        return res.result;
+    };
+    // Checks the cache lookups since the last call
+    LCompilers::LFortran::IncludeCacheStats stats
+        = LCompilers::LFortran::get_include_cache_stats();
+    auto check_lookups = [&](uint64_t hits, uint64_t misses) {
+        LCompilers::LFortran::IncludeCacheStats s
+            = LCompilers::LFortran::get_include_cache_stats();
+        CHECK(s.hits - stats.hits == hits);
+        CHECK(s.misses - stats.misses == misses);
+        stats = s;
+    };
+    std::string src = "#include \"" + header + "\"\ny = N\n";
+    // The second include of the same file is served from the cache, with the
+    // same output and the same macros defined
+    std::string single = preprocess(src, {});
+    CHECK(single.find("real :: x(3)") != std::string::npos);
+    CHECK(single.find("y = 3") != std::string::npos);
+    check_lookups(0, 1);
+    CHECK(preprocess(src, {}) == single);
+    check_lookups(1, 0);
+    // Different macros select different cache entries
+    std::string dp = preprocess(src, {"DP"});
+    CHECK(dp.find("real(8) :: x(3)") != std::string::npos);
+    check_lookups(0, 1);
+    CHECK(preprocess(src, {}) == single);
+    check_lookups(1, 0);
+    // A modified file is preprocessed again
+    {
+        std::ofstream out(header);
+        out << "#define N 4\nreal :: x(N)\n";
+    }
+    std::filesystem::last_write_time(header,
+        std::filesystem::last_write_time(header) + std::chrono::seconds(2));
+    std::string modified = preprocess(src, {});
+    CHECK(modified.find("real :: x(4)") != std::string::npos);
+    CHECK(modified.find("y = 4") != std::string::npos);
+    check_lookups(0, 1);
+    std::filesystem::remove(header);
+
+    // A modified nested include file invalidates the including file
+    std::string outer = "test_parse_cpp_outer.h";
+    std::string inner = "test_parse_cpp_inner.h";
+    {
+        std::ofstream out(outer);
+        out << "#include \"" << inner << "\"\nreal :: z(M)\n";
+    }
+    {
+        std::ofstream out(inner);
+        out << "#define M 5\n";
+    }
+    src = "#include \"" + outer + "\"\ny = M\n";
+    auto preprocess_nested = [&]() {
+        LCompilers::CompilerOptions co;
+        LCompilers::LFortran::CPreprocessor cpp(co);
+        LCompilers::LocationManager lm;
+        {
+            LCompilers::LocationManager::FileLocations fl;
+            fl.in_filename = "test_parse_cpp.f90";
+            lm.files.push_back(fl);
+        }
+        LCompilers::diag::Diagnostics diagnostics;
+        auto res = cpp.run(src, lm, cpp.macro_definitions, diagnostics);
+        REQUIRE(res.ok);
+        return res.result;
+    };
+    std::string nested = preprocess_nested();
+    CHECK(nested.find("real :: z(5)") != std::string::npos);
+    CHECK(nested.find("y = 5") != std::string::npos);
+    check_lookups(0, 2);
+    CHECK(preprocess_nested() == nested);
+    check_lookups(1, 0);
+    {
+        std::ofstream out(inner);
+        out << "#define M 6\n";
+    }
+    std::filesystem::last_write_time(inner,
+        std::filesystem::last_write_time(inner) + std::chrono::seconds(2));
+    nested = preprocess_nested();
+    CHECK(nested.find("real :: z(6)") != std::string::npos);
+    CHECK(nested.find("y = 6") != std::string::npos);
+    check_lookups(0, 2);
+    std::filesystem::remove(outer);
+    std::filesystem::remove(inner);
+}
+
 using tt = yytokentype;
 
 TEST_CASE("Tokenizer") {
@@ -1315,6 +1687,142 @@ TEST_CASE("Location") {
     CHECK(result->loc.last == 49);
 }
 
+TEST_CASE("Location encoding") {
+    std::vector<uint32_t> v = {0, 1, 129, 130, 70000, 5, 5, 0, UINT32_MAX, 0};
+    std::string s = LCompilers::encode_positions(v);
+    std::vector<uint32_t> w;
+    CHECK(LCompilers::decode_positions(s, w));
+    CHECK(w == v);
+    CHECK(LCompilers::encode_positions({}).empty());
+    CHECK(LCompilers::decode_positions("", w));
+    CHECK(w.empty());
+    // Truncated varint
+    CHECK(!LCompilers::decode_positions(std::string(1, (char)0x80), w));
+
+    std::vector<uint32_t> newlines;
+    for (uint32_t i = 0; i < 1000; i++) newlines.push_back(i*37 + i%5);
+    s = LCompilers::encode_positions(newlines);
+    CHECK(s.size() == newlines.size());
+    CHECK(LCompilers::decode_positions(s, w));
+    CHECK(w == newlines);
+
+    uint32_t hint = 0;
+    for (uint32_t pos : {0u, 1u, 36u, 37u, 38u, 500u, 40u, 36999u, 37100u,
+            37000u, 0u}) {
+        CHECK(LCompilers::bisection(newlines, pos, hint)
+            == LCompilers::bisection(newlines, pos));
+    }
+    std::vector<uint32_t> empty;
+    CHECK(LCompilers::bisection(empty, 5, hint) == 0);
+
+    LCompilers::LocationManager lm;
+    {
+        LCompilers::LocationManager::FileLocations fl;
+        fl.in_filename = "input.f90";
+        lm.files.push_back(fl);
+    }
+    std::string input = "a\nbc\n\ndef\n";
+    lm.init_simple(input);
+    lm.file_ends.push_back(input.size());
+    uint32_t line, col;
+    std::string filename;
+    std::vector<std::pair<uint32_t, uint32_t>> linecol = {{1, 1}, {1, 2},
+        {2, 1}, {2, 2}, {2, 3}, {3, 1}, {4, 1}, {4, 2}, {4, 3}, {4, 4}};
+    for (uint32_t pos = 0; pos < input.size(); pos++) {
+        lm.pos_to_linecol(pos, line, col, filename);
+        CHECK(line == linecol[pos].first);
+        CHECK(col == linecol[pos].second);
+    }
+    lm.pos_to_linecol(3, line, col, filename);
+    CHECK(line == 2);
+    CHECK(col == 2);
+    CHECK(filename == "input.f90");
+    CHECK(lm.linecol_to_pos(1, 1) == 1);
+    CHECK(lm.linecol_to_pos(4, 2) == 7);
+    CHECK(lm.linecol_to_pos(5, 1) == 0);
+    CHECK(lm.linecol_to_pos(0, 1) == 0);
+}
+
+TEST_CASE("Parallel parsing") {
+    std::string input = R"(! Header
+module m
+implicit none
+contains
+    integer function g(x) result(r)
+    integer, intent(in) :: x
+    r = x + 1
+    end function
+end module m
+)";
+    for (int i = 0; i < 2000; i++) {
+        std::string n = std::to_string(i);
+        input += "subroutine f" + n + "(x)\n"
+            "real(8), intent(inout) :: x\n"
+            "x = x * " + n + " + 1\n"
+            "end subroutine f" + n + "\n"
+            "! comment after f" + n + "\n\n";
+    }
+    input += R"(pure real(8) function h(y)
+real(8), intent(in) :: y
+interface operator(.x.)
+    module procedure g
+end interface operator(.x.)
+h = y
+end function
+program main
+call f0(1.0d0)
+end program main)";
+
+    std::vector<size_t> splits = LCompilers::LFortran::split_program_units(
+        input, 4, 1024);
+    REQUIRE(splits.size() == 3);
+    for (size_t i = 0; i < splits.size(); i++) {
+        // Every chunk starts with a subroutine
+        CHECK(input.compare(splits[i], 11, "subroutine ") == 0);
+    }
+    CHECK(LCompilers::LFortran::split_program_units(input, 1, 1024).empty());
+    CHECK(LCompilers::LFortran::split_program_units(input, 4,
+        input.size()).empty());
+    // A main program without the `program` line is not split
+    CHECK(LCompilers::LFortran::split_program_units(
+        "x = 1\nend\nsubroutine f\nend\n", 2, 1).empty());
+
+    Allocator al(1024*1024);
+    LCompilers::diag::Diagnostics diagnostics;
+    LCompilers::CompilerOptions co;
+    auto ast1 = TRY(parse(al, input, diagnostics, co));
+    co.parse_threads = 4;
+    auto ast2 = TRY(parse(al, input, diagnostics, co));
+    CHECK(diagnostics.diagnostics.size() == 0);
+    CHECK(LCompilers::LFortran::pickle(*ast1)
+        == LCompilers::LFortran::pickle(*ast2));
+    REQUIRE(ast1->n_items == ast2->n_items);
+    CHECK(ast1->base.base.loc.first == ast2->base.base.loc.first);
+    CHECK(ast1->base.base.loc.last == ast2->base.base.loc.last);
+    for (size_t i = 0; i < ast1->n_items; i++) {
+        CHECK(ast1->m_items[i]->loc.first == ast2->m_items[i]->loc.first);
+        CHECK(ast1->m_items[i]->loc.last == ast2->m_items[i]->loc.last);
+    }
+
+    // An error in a chunk is reported as by the sequential parser
+    std::string input2 = input;
+    size_t pos = input2.find("x = x * 1500");
+    input2.replace(pos, 1, ")");
+    LCompilers::diag::Diagnostics diagnostics1, diagnostics2;
+    co.parse_threads = 1;
+    CHECK(!parse(al, input2, diagnostics1, co).ok);
+    co.parse_threads = 4;
+    CHECK(!parse(al, input2, diagnostics2, co).ok);
+    REQUIRE(diagnostics1.diagnostics.size() == 1);
+    REQUIRE(diagnostics2.diagnostics.size() == 1);
+    CHECK(diagnostics1.diagnostics[0].message
+        == diagnostics2.diagnostics[0].message);
+    CHECK(diagnostics1.diagnostics[0].labels[0].spans[0].loc.first
+        == pos);
+    CHECK(diagnostics2.diagnostics[0].labels[0].spans[0].loc.first
+        == pos);
+}
+
 TEST_CASE("Errors") {
     Allocator al(1024*1024);
     std::string input;
@@ -1395,3 +1903,52 @@ TEST_CASE("Errors") {
     CHECK(diagnostics.diagnostics[0].labels[0].spans[0].loc.last == 2);
     diagnostics.diagnostics.clear();
 }
+
+TEST_CASE("Module dependencies") {
+    using LCompilers::LFortran::ModuleDependencies;
+    using LCompilers::LFortran::scan_module_dependencies;
+    using LCompilers::LFortran::module_dependency_graph;
+
+    ModuleDependencies a = scan_module_dependencies(R"(
+module A_mod
+use, intrinsic :: iso_fortran_env, only: dp => real64
+use b_mod, only: f
+! use c_mod
+implicit none
+interface
+    module subroutine s()
+    end subroutine
+end interface
+contains
+    module procedure g
+    end procedure
+end module
+)");
+    CHECK(a.provides == std::vector<std::string>({"a_mod"}));
+    CHECK(a.uses == std::vector<std::string>({"b_mod"}));
+
+    ModuleDependencies b = scan_module_dependencies(R"(
+module b_mod
+use :: c_mod
+use, non_intrinsic :: d_mod
+end module b_mod
+submodule (a_mod) a_impl
+end submodule
+)");
+    CHECK(b.provides == std::vector<std::string>({"b_mod"}));
+    CHECK(b.uses == std::vector<std::string>({"c_mod", "d_mod", "a_mod"}));
+
+    ModuleDependencies main = scan_module_dependencies(R"(
+program main
+use a_mod
+use b_mod
+end program
+)");
+    CHECK(main.provides.size() == 0);
+
+    std::vector<std::vector<size_t>> graph =
+        module_dependency_graph({main, a, b});
+    CHECK(graph[0] == std::vector<size_t>({1, 2}));
+    CHECK(graph[1] == std::vector<size_t>({2}));
+    CHECK(graph[2] == std::vector<size_t>({1}));
+}
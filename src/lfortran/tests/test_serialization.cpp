@@ -1,5 +1,7 @@
 #include <tests/doctest.h>
 #include <iostream>
+#include <filesystem>
+#include <fstream>
 
 #include <libasr/bwriter.h>
 #include <libasr/serialization.h>
@@ -331,6 +333,72 @@ end module
 
 }
 
+TEST_CASE("ASR lazy modfile loading") {
+    Allocator al(4*1024);
+    std::string src = R"""(
+module lazy_mod
+implicit none
+
+contains
+
+integer function f(x)
+integer, intent(in) :: x
+f = h(x) + 1
+end function
+
+integer function g(x)
+integer, intent(in) :: x
+g = 2*x
+end function
+
+integer function h(x)
+integer, intent(in) :: x
+h = x*x
+end function
+
+end module
+)""";
+    LCompilers::diag::Diagnostics diagnostics;
+    LCompilers::CompilerOptions compiler_options;
+    LCompilers::LFortran::AST::TranslationUnit_t* ast0 = TRY(
+        LCompilers::LFortran::parse(al, src, diagnostics, compiler_options));
+    LCompilers::LocationManager lm;
+    lm.file_ends.push_back(0);
+    LCompilers::LocationManager::FileLocations file;
+    file.in_filename = "test"; file.current_line = 1; file.preprocessor = false;
+    lm.files.push_back(file);
+    LCompilers::ASR::TranslationUnit_t* asr = TRY(LCompilers::LFortran::ast_to_asr(al, *ast0,
+        diagnostics, nullptr, false, compiler_options, lm));
+    std::string path = (std::filesystem::temp_directory_path()
+        / "lfortran_test_lazy_mod.mod").string();
+    {
+        std::ofstream out(path, std::ofstream::binary);
+        out << LCompilers::save_modfile(*asr, lm);
+    }
+
+    LCompilers::SymbolTable symtab(nullptr);
+    LCompilers::ASR::TranslationUnit_t *asr2 = LCompilers::load_modfile_from_path(
+        al, path, true, symtab, lm, true);
+    REQUIRE(asr2);
+    LCompilers::SymbolTable *mod_symtab = LCompilers::ASRUtils::symbol_symtab(
+        asr2->m_symtab->get_symbol("lazy_mod"));
+    CHECK(mod_symtab->get_loaded_scope().size() == 0);
+    // Loading `f` also loads `h`, which it calls
+    CHECK(mod_symtab->get_symbol("f") != nullptr);
+    CHECK(mod_symtab->get_loaded_scope().size() == 2);
+    CHECK(mod_symtab->get_loaded_scope().count("h") == 1);
+    CHECK(mod_symtab->get_symbol("unknown") == nullptr);
+    // Walks over the ASR only visit the loaded symbols
+    fix_external_symbols(*asr2, symtab);
+    CHECK(mod_symtab->get_loaded_scope().size() == 2);
+    // Iterating over the symbols loads all of them
+    CHECK(mod_symtab->get_scope().size() == 3);
+    CHECK(mod_symtab->get_loaded_scope().size() == 3);
+    CHECK(LCompilers::asr_verify(*asr2, true, diagnostics));
+    CHECK(LCompilers::pickle(*asr) == LCompilers::pickle(*asr2));
+    std::filesystem::remove(path);
+}
+
 TEST_CASE("Topological sorting mod_int") {
     std::map<std::string, std::vector<std::string>> deps;
     // 1 depends on 2
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <memory>
 #include <new>
 #include <stdexcept>
 #include <vector>
@@ -15,12 +16,49 @@ inline size_t align(size_t n) {
   return (n + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
 }
 
+// Memory usage statistics of an Allocator, see `Allocator::stats()`
+struct AllocatorStats {
+    // Sum of the sizes passed to `alloc()`
+    size_t bytes_requested = 0;
+    // Bytes handed out, `bytes_requested` plus the alignment padding
+    size_t bytes_allocated = 0;
+    // Bytes lost to the alignment of the allocations
+    size_t bytes_alignment = 0;
+    // Total size of the chunks in use
+    size_t bytes_reserved = 0;
+    // Total size of the retired chunks kept for reuse
+    size_t bytes_free = 0;
+    // Maximum of `bytes_allocated` over the lifetime of the Allocator
+    size_t peak_bytes_allocated = 0;
+    // Number of chunks in use
+    size_t num_chunks = 0;
+};
+
 class Allocator
 {
+    struct Block {
+        void *start;
+        size_t size;
+    };
+
     void *start;
     size_t current_pos;
     size_t size;
-    std::vector<void*> blocks;
+    std::vector<Block> blocks;
+    // Chunks retired by `release()`, reused by `new_chunk()`
+    std::vector<Block> free_blocks;
+    // Chunks taken over from other allocators by `adopt()`
+    std::vector<Block> adopted_blocks;
+    size_t adopted_bytes_allocated = 0;
+    size_t adopted_bytes_requested = 0;
+    // Bytes allocated in all chunks before the current one
+    size_t previous_chunks_allocated = 0;
+    size_t bytes_requested = 0;
+    size_t peak_bytes_allocated = 0;
+    // Objects destroyed together with the Allocator, see `keep()`
+    std::vector<std::shared_ptr<const void>> kept_objects;
+    // The objects kept by the allocators taken over by `adopt()`
+    std::vector<std::shared_ptr<const void>> adopted_objects;
 public:
     Allocator(size_t s) {
         s += ALIGNMENT;
@@ -29,7 +67,7 @@ public:
         current_pos = (size_t)start;
         current_pos = align(current_pos);
         size = s;
-        blocks.push_back(start);
+        blocks.push_back({start, s});
     }
     Allocator() = delete;
     Allocator(const Allocator&) = delete;
@@ -37,9 +75,13 @@ public:
     Allocator(const Allocator&&) = delete;
     Allocator& operator=(const Allocator&&) = delete;
     ~Allocator() {
+        kept_objects.clear();
+        adopted_objects.clear();
         for (size_t i = 0; i < blocks.size(); i++) {
-            if (blocks[i] != nullptr) free(blocks[i]);
+            if (blocks[i].start != nullptr) free(blocks[i].start);
         }
+        for (auto &block : adopted_blocks) free(block.start);
+        release_free_blocks();
     }
 
     // Allocates `s` bytes of memory, returns a pointer to it
@@ -58,6 +100,7 @@ public:
             LCOMPILERS_ASSERT(start != nullptr);
             size_t addr = current_pos;
             current_pos += align(s);
+            bytes_requested += s;
             if (size_current() > size_total()) {
 #ifdef LCOMPILERS_FAST_ALLOC
                 throw std::bad_alloc();
@@ -73,13 +116,31 @@ public:
 #endif
     }
 
+    // Called by `alloc(s)` when `s` bytes do not fit in the current chunk
+    // (`current_pos` has already been advanced past the end of it)
     void *new_chunk(size_t s) {
+        previous_chunks_allocated += current_pos - align(s)
+            - align((size_t)start);
         size_t snew = std::max(s+ALIGNMENT, 2*size);
-        start = malloc(snew);
-        blocks.push_back(start);
-        if (start == nullptr) {
-            throw std::runtime_error("malloc failed.");
+        // Reuse the smallest retired chunk that is large enough
+        size_t best = free_blocks.size();
+        for (size_t i = 0; i < free_blocks.size(); i++) {
+            if (free_blocks[i].size >= snew && (best == free_blocks.size()
+                    || free_blocks[i].size < free_blocks[best].size)) {
+                best = i;
+            }
         }
+        if (best < free_blocks.size()) {
+            start = free_blocks[best].start;
+            snew = free_blocks[best].size;
+            free_blocks.erase(free_blocks.begin() + best);
+        } else {
+            start = malloc(snew);
+            if (start == nullptr) {
+                throw std::runtime_error("malloc failed.");
+            }
+        }
+        blocks.push_back({start, snew});
         current_pos = (size_t)start;
         current_pos = align(current_pos);
         size = snew;
@@ -112,6 +173,110 @@ public:
         //return new T(std::forward<Args>(args)...);
     }
 
+    // Keeps `object` alive as long as the Allocator, or until the memory
+    // allocated before the call is freed by `release()` or `reset()`. For
+    // objects that own memory outside of the Allocator (containers, mapped
+    // files) and are referenced from the memory of the Allocator, where
+    // destructors never run.
+    template <class T>
+    T *keep(std::shared_ptr<T> object) {
+        kept_objects.push_back(object);
+        return object.get();
+    }
+
+    // A checkpoint of the Allocator, see `mark()` and `release()`
+    struct Mark {
+        size_t num_chunks;
+        size_t current_pos;
+        size_t previous_chunks_allocated;
+        size_t bytes_requested;
+        size_t num_kept_objects;
+    };
+
+    // Returns a checkpoint, everything allocated (and kept) after it can be
+    // freed at once by `release()`
+    Mark mark() {
+        return {blocks.size(), current_pos, previous_chunks_allocated,
+            bytes_requested, kept_objects.size()};
+    }
+
+    // Frees everything allocated after the checkpoint `m` was taken and drops
+    // the objects kept after it. The memory must not be used anymore and no
+    // destructors are called. Marks must be released in the reverse order in
+    // which they were taken. The chunks allocated after `m` are kept and
+    // reused by later allocations.
+    void release(const Mark &m) {
+        LCOMPILERS_ASSERT(m.num_chunks >= 1 && m.num_chunks <= blocks.size());
+        LCOMPILERS_ASSERT(m.num_kept_objects <= kept_objects.size());
+        update_peak();
+        kept_objects.resize(m.num_kept_objects);
+        while (blocks.size() > m.num_chunks) {
+            free_blocks.push_back(blocks.back());
+            blocks.pop_back();
+        }
+        start = blocks.back().start;
+        size = blocks.back().size;
+        current_pos = m.current_pos;
+        previous_chunks_allocated = m.previous_chunks_allocated;
+        bytes_requested = m.bytes_requested;
+        LCOMPILERS_ASSERT(size_current() <= size_total());
+    }
+
+    // Frees everything allocated so far, keeping the chunks for reuse
+    void reset() {
+        release({1, align((size_t)blocks[0].start), 0, 0, 0});
+    }
+
+    // Takes over the chunks of `other`, so that everything allocated in it
+    // stays valid for the lifetime of this Allocator. Used to keep the
+    // results of work done on other threads with their own Allocator.
+    // `other` cannot allocate anymore. The adopted memory and the objects
+    // that `other` kept are not affected by `release()` and `reset()`.
+    void adopt(Allocator &other) {
+        other.update_peak();
+        // Includes the chunks adopted by `other`
+        adopted_bytes_allocated += other.bytes_allocated();
+        adopted_bytes_requested += other.bytes_requested
+            + other.adopted_bytes_requested;
+        adopted_blocks.insert(adopted_blocks.end(), other.blocks.begin(),
+            other.blocks.end());
+        adopted_blocks.insert(adopted_blocks.end(),
+            other.adopted_blocks.begin(), other.adopted_blocks.end());
+        adopted_objects.insert(adopted_objects.end(),
+            other.kept_objects.begin(), other.kept_objects.end());
+        adopted_objects.insert(adopted_objects.end(),
+            other.adopted_objects.begin(), other.adopted_objects.end());
+        other.blocks.clear();
+        other.adopted_blocks.clear();
+        other.kept_objects.clear();
+        other.adopted_objects.clear();
+        other.adopted_bytes_allocated = 0;
+        other.adopted_bytes_requested = 0;
+        other.start = nullptr;
+        other.current_pos = 0;
+        other.size = 0;
+    }
+
+    // Returns the retired chunks to the system
+    void release_free_blocks() {
+        for (auto &block : free_blocks) free(block.start);
+        free_blocks.clear();
+    }
+
+    AllocatorStats stats() {
+        update_peak();
+        AllocatorStats s;
+        s.bytes_requested = bytes_requested + adopted_bytes_requested;
+        s.bytes_allocated = bytes_allocated();
+        s.bytes_alignment = s.bytes_allocated - s.bytes_requested;
+        for (auto &block : blocks) s.bytes_reserved += block.size;
+        for (auto &block : adopted_blocks) s.bytes_reserved += block.size;
+        for (auto &block : free_blocks) s.bytes_free += block.size;
+        s.peak_bytes_allocated = peak_bytes_allocated;
+        s.num_chunks = blocks.size() + adopted_blocks.size();
+        return s;
+    }
+
     size_t size_current() {
         return current_pos - (size_t)start;
     }
@@ -123,6 +288,35 @@ public:
     size_t num_chunks() {
         return blocks.size();
     }
+
+private:
+    size_t bytes_allocated() {
+        // The first chunk starts at an aligned position
+        return adopted_bytes_allocated + previous_chunks_allocated
+            + current_pos - align((size_t)start);
+    }
+
+    void update_peak() {
+        peak_bytes_allocated = std::max(peak_bytes_allocated, bytes_allocated());
+    }
+};
+
+// Releases everything allocated in `al` during the lifetime of the scope:
+//
+//     {
+//         AllocatorScope scope(al);
+//         // Temporary allocations
+//     }
+class AllocatorScope {
+    Allocator &al;
+    Allocator::Mark m;
+public:
+    AllocatorScope(Allocator &al) : al{al}, m{al.mark()} {}
+    AllocatorScope(const AllocatorScope&) = delete;
+    AllocatorScope& operator=(const AllocatorScope&) = delete;
+    ~AllocatorScope() {
+        al.release(m);
+    }
 };
 
 #endif
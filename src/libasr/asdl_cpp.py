@@ -523,7 +523,7 @@ class DefaultLookupNameVisitor(ASDLVisitor):
         elif field.type == "symbol_table" and field.name in["symtab",
                 "global_scope"]:
             self.used = True
-            self.emit("for (auto &a : x.m_%s->get_scope()) {" % field.name, 2)
+            self.emit("for (auto &a : x.m_%s->get_loaded_scope()) {" % field.name, 2)
             self.emit(  "this->visit_symbol(*a.second);", 3)
             self.emit("}", 2)
 
@@ -605,7 +605,7 @@ class ASTWalkVisitorVisitor(ASDLVisitor):
         elif field.type == "symbol_table" and field.name in["symtab",
                 "global_scope"]:
             self.used = True
-            self.emit("for (auto &a : x.m_%s->get_scope()) {" % field.name, 2)
+            self.emit("for (auto &a : x.m_%s->get_loaded_scope()) {" % field.name, 2)
             self.emit(  "this->visit_symbol(*a.second);", 3)
             self.emit("}", 2)
 
@@ -710,7 +710,7 @@ class ASRPassWalkVisitorVisitor(ASDLVisitor):
         elif field.type == "symbol_table" and field.name in["symtab",
                 "global_scope"]:
             self.used = True
-            self.emit("for (auto &a : x.m_%s->get_scope()) {" % field.name, 2)
+            self.emit("for (auto &a : x.m_%s->get_loaded_scope()) {" % field.name, 2)
             self.emit(  "this->visit_symbol(*a.second);", 3)
             self.emit("}", 2)
 
@@ -854,7 +854,7 @@ class CallReplacerOnExpressionsVisitor(ASDLVisitor):
         elif field.type == "symbol_table" and field.name in["symtab",
                 "global_scope"]:
             self.used = True
-            self.emit("for (auto &a : x.m_%s->get_scope()) {" % field.name, 2)
+            self.emit("for (auto &a : x.m_%s->get_loaded_scope()) {" % field.name, 2)
             self.emit(  "this->visit_symbol(*a.second);", 3)
             self.emit("}", 2)
 
@@ -2238,6 +2238,16 @@ class SerializationVisitorVisitor(ASDLVisitor):
         self.emit("private:")
         self.emit(  "StructType& self() { return static_cast<StructType&>(*this); }", 1)
         self.emit("public:")
+        self.emit(  "// Locations and symbol table counters are written through these, so", 1)
+        self.emit(  "// that a derived visitor can leave them out (e.g. `structural_hash()`)", 1)
+        self.emit(  "void write_location(const Location &loc) {", 1)
+        self.emit(  "    self().write_int64(loc.first);", 1)
+        self.emit(  "    self().write_int64(loc.last);", 1)
+        self.emit(  "}", 1)
+        if mod.name.upper() == "ASR":
+            self.emit(  "void write_symtab_id(const SymbolTable &symtab) {", 1)
+            self.emit(  "    self().write_int64(symtab.counter);", 1)
+            self.emit(  "}", 1)
         self.mod = mod
         super(SerializationVisitorVisitor, self).visitModule(mod)
         self.emit("};")
@@ -2264,8 +2274,7 @@ class SerializationVisitorVisitor(ASDLVisitor):
         self.emit("void visit_%s(const %s_t &x) {" % (name, name), 1)
         if cons:
             self.emit(    'self().write_int8(x.base.type);', 2)
-            self.emit(    'self().write_int64(x.base.base.loc.first);', 2)
-            self.emit(    'self().write_int64(x.base.base.loc.last);', 2)
+            self.emit(    'self().write_location(x.base.base.loc);', 2)
         self.used = False
         for n, field in enumerate(fields):
             self.visitField(field, cons, name)
@@ -2356,22 +2365,20 @@ class SerializationVisitorVisitor(ASDLVisitor):
                 # TODO: write the symbol table consistent with the reader:
                 if field.name == "parent_symtab":
                     level = 2
-                    self.emit('self().write_int64(x.m_%s->counter);' % field.name, level)
+                    self.emit('self().write_symtab_id(*x.m_%s);' % field.name, level)
                 else:
                     level = 2
-                    self.emit('self().write_int64(x.m_%s->counter);' % field.name, level)
+                    self.emit('self().write_symtab_id(*x.m_%s);' % field.name, level)
                     self.emit('self().write_int64(x.m_%s->get_scope().size());' % field.name, level)
                     self.emit('for (auto &a : x.m_%s->get_scope()) {' % field.name, level)
                     self.emit('    if (ASR::is_a<ASR::Function_t>(*a.second)) {', level)
                     self.emit('        continue;', level)
                     self.emit('    }', level)
-                    self.emit('    self().write_string(a.first);', level)
-                    self.emit('    this->visit_symbol(*a.second);', level)
+                    self.emit('    self().write_symtab_entry(a.first, *a.second);', level)
                     self.emit('}', level)
                     self.emit('for (auto &a : x.m_%s->get_scope()) {' % field.name, level)
                     self.emit('    if (ASR::is_a<ASR::Function_t>(*a.second)) {', level)
-                    self.emit('        self().write_string(a.first);', level)
-                    self.emit('        this->visit_symbol(*a.second);', level)
+                    self.emit('        self().write_symtab_entry(a.first, *a.second);', level)
                     self.emit('    }', level)
                     self.emit('}', level)
             elif field.type == "string" and not field.seq:
@@ -2671,9 +2678,7 @@ class DeserializationVisitorVisitor(ASDLVisitor):
                             lines.append("{")
                             lines.append("    size_t n = self().read_int64();")
                             lines.append("    for (size_t i=0; i<n; i++) {")
-                            lines.append("        std::string name = self().read_string();")
-                            lines.append("        symbol_t *sym = down_cast<symbol_t>(deserialize_symbol());")
-                            lines.append("        self().symtab_insert_symbol(*m_%s, name, sym);" % f.name)
+                            lines.append("        self().read_symtab_entry(*m_%s);" % f.name)
                             lines.append("    }")
                             lines.append("}")
                     elif f.type == "void":
@@ -31,6 +31,7 @@ void SymbolTable::reset_global_counter() {
 }
 
 void SymbolTable::mark_all_variables_external(Allocator &al) {
+    load_all_symbols();
     for (auto &a : scope) {
         switch (a.second->type) {
             case (ASR::symbolType::Variable) : {
@@ -64,8 +65,8 @@ ASR::symbol_t *SymbolTable::find_scoped_symbol(const std::string &name,
     const SymbolTable *s = this;
     for(size_t i=0; i < n_scope_names; i++) {
         std::string scope_name = m_scope_names[i];
-        if (s->scope.find(scope_name) != scope.end()) {
-            ASR::symbol_t *sym = s->scope.at(scope_name);
+        ASR::symbol_t *sym = s->get_symbol(scope_name);
+        if (sym) {
             s = ASRUtils::symbol_symtab(sym);
             if (s == nullptr) {
                 // The m_scope_names[i] found in the appropriate symbol table,
@@ -78,9 +79,8 @@ ASR::symbol_t *SymbolTable::find_scoped_symbol(const std::string &name,
             return nullptr;
         }
     }
-    if (s->scope.find(name) != scope.end()) {
-        ASR::symbol_t *sym = s->scope.at(name);
-        LCOMPILERS_ASSERT(sym)
+    ASR::symbol_t *sym = s->get_symbol(name);
+    if (sym) {
         return sym;
     } else {
         // The `name` not found in the appropriate symbol table
@@ -94,7 +94,7 @@ std::string SymbolTable::get_unique_name(const std::string &name, bool use_uniqu
         unique_name += "_" + lcompilers_unique_ID;
     }
     int counter = 1;
-    while (scope.find(unique_name) != scope.end()) {
+    while (get_symbol(unique_name) != nullptr) {
         unique_name = name + std::to_string(counter);
         counter++;
     }
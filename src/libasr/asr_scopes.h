@@ -1,7 +1,12 @@
 #ifndef LFORTRAN_SEMANTICS_ASR_SCOPES_H
 #define LFORTRAN_SEMANTICS_ASR_SCOPES_H
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <map>
+#include <string_view>
+#include <vector>
 
 #include <libasr/alloc.h>
 #include <libasr/containers.h>
@@ -15,9 +20,151 @@ namespace ASR {
     struct symbol_t;
 }
 
+// Materializes the symbols of a symbol table on demand (used for modules
+// loaded lazily from modfiles)
+struct LazySymbolLoader {
+    // Loads the symbol `name` into the symbol table, returns `nullptr` if
+    // there is no such symbol or if it is being loaded
+    virtual ASR::symbol_t* load_symbol(const std::string &name) = 0;
+    // Loads all the remaining symbols
+    virtual void load_all() = 0;
+    virtual ~LazySymbolLoader() {}
+};
+
+// Open addressing hash table (linear probing) over the entries of the
+// `std::map` of a SymbolTable. The map nodes never move, so the table only
+// stores the hash and a pointer to the entry. Lookups are a probe of a
+// contiguous array instead of a walk down a tree with string comparisons,
+// while the map keeps the sorted iteration order that printing and
+// serialization of the ASR rely on.
+class SymbolIndex {
+public:
+    typedef std::map<std::string, ASR::symbol_t*, std::less<>> Map;
+    typedef Map::value_type Entry;
+
+    static size_t hash(std::string_view name) {
+        return std::hash<std::string_view>()(name);
+    }
+
+    // Returns the entry of `name` (with hash `h`) or `nullptr`
+    Entry *find(std::string_view name, size_t h) const {
+        if (slots.empty()) return nullptr;
+        size_t mask = slots.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            const Slot &slot = slots[i];
+            if (!slot.entry) return nullptr;
+            if (slot.hash == h && slot.entry->first == name) return slot.entry;
+        }
+    }
+
+    // Adds an entry that is not in the table yet
+    void insert(Entry *entry, size_t h) {
+        if ((n + 1) * 4 > slots.size() * 3) rehash(std::max<size_t>(16, 2 * slots.size()));
+        place(entry, h);
+        n++;
+    }
+
+    // Removes the entry of `name` if present. The following entries of the
+    // probe sequence are shifted back, so that no tombstones are needed.
+    void erase(std::string_view name, size_t h) {
+        if (slots.empty()) return;
+        size_t mask = slots.size() - 1;
+        size_t i = h & mask;
+        for (;; i = (i + 1) & mask) {
+            if (!slots[i].entry) return;
+            if (slots[i].hash == h && slots[i].entry->first == name) break;
+        }
+        for (size_t j = (i + 1) & mask; slots[j].entry; j = (j + 1) & mask) {
+            size_t home = slots[j].hash & mask;
+            // The entry at `j` can move to `i` if its home slot is not in
+            // the cyclic interval (i, j]
+            bool in_between = (i <= j) ? (i < home && home <= j)
+                                       : (i < home || home <= j);
+            if (!in_between) {
+                slots[i] = slots[j];
+                i = j;
+            }
+        }
+        slots[i] = Slot();
+        n--;
+    }
+
+    size_t size() const {
+        return n;
+    }
+
+private:
+    struct Slot {
+        size_t hash = 0;
+        Entry *entry = nullptr;
+    };
+    // The size is a power of two
+    std::vector<Slot> slots;
+    size_t n = 0;
+
+    void place(Entry *entry, size_t h) {
+        size_t mask = slots.size() - 1;
+        size_t i = h & mask;
+        while (slots[i].entry) i = (i + 1) & mask;
+        slots[i].hash = h;
+        slots[i].entry = entry;
+    }
+
+    void rehash(size_t size) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(size);
+        for (auto &slot : old) {
+            if (slot.entry) place(slot.entry, slot.hash);
+        }
+    }
+};
+
 struct SymbolTable {
     private:
-    std::map<std::string, ASR::symbol_t*> scope;
+    // Sorted by name, the iteration order of `get_scope()`
+    SymbolIndex::Map scope;
+    // Hash index of `scope`, used for all lookups
+    SymbolIndex index;
+    // Only used in the global scope: the list that the changed symbol tables
+    // of the tree are recorded in, see `track_changes()`
+    std::vector<SymbolTable*> *changed_scopes = nullptr;
+    // The list that this symbol table is recorded in
+    const std::vector<SymbolTable*> *changes_recorded_in = nullptr;
+
+    // Records a change of this symbol table in the list of the global scope.
+    // The flags are kept if the symbol table was recorded in another list
+    // before (e.g. it moved to another tree).
+    void mark_changed(bool replaced) {
+        if (replaced) {
+            symbols_replaced = true;
+        } else {
+            symbols_added = true;
+        }
+        SymbolTable *global_scope = get_global_scope();
+        if (!global_scope->changed_scopes) {
+            global_scope->untracked_changes = true;
+        } else if (changes_recorded_in != global_scope->changed_scopes) {
+            global_scope->changed_scopes->push_back(this);
+            changes_recorded_in = global_scope->changed_scopes;
+        }
+    }
+
+    ASR::symbol_t* resolve_symbol(std::string_view name, size_t h) {
+        SymbolIndex::Entry *e = index.find(name, h);
+        if (e) return e->second;
+        if (lazy_loader) {
+            ASR::symbol_t *sym = lazy_loader->load_symbol(std::string(name));
+            if (sym) return sym;
+        }
+        if (parent) {
+            // The hash of the name is computed once for the whole chain of
+            // parent scopes
+            return parent->resolve_symbol(name, h);
+        } else {
+            return nullptr;
+        }
+    }
 
     public:
     SymbolTable *parent;
@@ -27,8 +174,25 @@ struct SymbolTable {
     // * down_cast2<TranslationUnit_t>(this->asr_owner)->m_symtab == this
     ASR::asr_t *asr_owner = nullptr;
     unsigned int counter;
+    // If set, symbols not in `scope` yet are loaded on demand by
+    // `get_symbol()` and `resolve_symbol()`, and all of them by
+    // `get_scope()`. The loader is owned by the Allocator of the ASR.
+    mutable LazySymbolLoader *lazy_loader = nullptr;
+    // Whether symbols were added to, or removed from or replaced in this
+    // symbol table since the last `clear_changed_scopes()` of a list that it
+    // was recorded in
+    bool symbols_added = false;
+    bool symbols_replaced = false;
+    // Only used in the global scope: whether a symbol table of the tree
+    // changed while no list was attached. Atomic, as the threads of
+    // `PassManager::apply_procedure_pass()` change their procedures
+    // concurrently.
+    std::atomic<bool> untracked_changes = false;
 
     SymbolTable(SymbolTable *parent);
+    // The index points into `scope`, a copy would point into the original
+    SymbolTable(const SymbolTable &) = delete;
+    SymbolTable &operator=(const SymbolTable &) = delete;
 
     // Determines a stable hash based on the content of the symbol table
     uint32_t get_hash_uint32(); // Returns the hash as an integer
@@ -36,18 +200,59 @@ struct SymbolTable {
         return std::to_string(counter);
     }
     static void reset_global_counter(); // Resets the internal global counter
+    // Records the symbol tables of the tree that change from now on in
+    // `list`, called on the global scope. The list is owned by the caller,
+    // outside of the Allocator of the ASR (see `ChangedScopesTracker`);
+    // `nullptr` stops the recording. Changes that are still recorded in the
+    // previous list become untracked.
+    void track_changes(std::vector<SymbolTable*> *list) {
+        if (changed_scopes && !changed_scopes->empty()) {
+            untracked_changes = true;
+            for (SymbolTable *symtab : *changed_scopes) {
+                if (symtab->changes_recorded_in == changed_scopes) {
+                    symtab->changes_recorded_in = nullptr;
+                }
+            }
+            std::vector<SymbolTable*>().swap(*changed_scopes);
+        }
+        changed_scopes = list;
+    }
+
+    // The symbol tables of the tree that changed since the last
+    // `clear_changed_scopes()`, called on the global scope. If
+    // `untracked_changes` is set, other symbol tables might have changed too.
+    const std::vector<SymbolTable*> &get_changed_scopes() const {
+        static const std::vector<SymbolTable*> none;
+        return changed_scopes ? *changed_scopes : none;
+    }
+
+    // Whether the changes are recorded in a list, called on the global scope
+    bool tracks_changes() const {
+        return changed_scopes != nullptr;
+    }
+
+    bool has_changes() const {
+        return untracked_changes || !get_changed_scopes().empty();
+    }
+
+    // Resets the changes of the recorded symbol tables and frees the list,
+    // called on the global scope
+    void clear_changed_scopes() {
+        untracked_changes = false;
+        if (!changed_scopes) return;
+        for (SymbolTable *symtab : *changed_scopes) {
+            if (symtab->changes_recorded_in != changed_scopes) continue;
+            symtab->changes_recorded_in = nullptr;
+            symtab->symbols_added = false;
+            symtab->symbols_replaced = false;
+        }
+        std::vector<SymbolTable*>().swap(*changed_scopes);
+    }
 
     // Resolves the symbol `name` recursively in current and parent scopes.
     // Returns `nullptr` if symbol not found.
-    ASR::symbol_t* resolve_symbol(const std::string &name) {
-        if (scope.find(name) == scope.end()) {
-            if (parent) {
-                return parent->resolve_symbol(name);
-            } else {
-                return nullptr;
-            }
-        }
-        return scope[name];
+    ASR::symbol_t* resolve_symbol(std::string_view name) {
+        return resolve_symbol(name, SymbolIndex::hash(name));
     }
 
     SymbolTable* get_global_scope() {
@@ -58,44 +263,73 @@ struct SymbolTable {
         return global_scope;
     }
 
-    const std::map<std::string, ASR::symbol_t*>& get_scope() const {
+    // All the symbols, sorted by name. The symbols of a lazily loaded symbol
+    // table that are not loaded yet are loaded first.
+    const SymbolIndex::Map& get_scope() const {
+        load_all_symbols();
         return scope;
     }
 
+    // Only the symbols loaded so far. Used by the walks over the ASR: a
+    // symbol that is not loaded yet is not referenced by any loaded node.
+    const SymbolIndex::Map& get_loaded_scope() const {
+        return scope;
+    }
+
+    // Loads all symbols of a lazily loaded symbol table
+    void load_all_symbols() const {
+        if (lazy_loader) {
+            lazy_loader->load_all();
+            lazy_loader = nullptr;
+        }
+    }
+
     // Obtains the symbol `name` from the current symbol table
     // Returns `nullptr` if symbol not found.
-    ASR::symbol_t* get_symbol(const std::string &name) const {
-        //auto it = scope.find(to_lower(name));
-        auto it = scope.find(name);
-        if (it == scope.end()) {
-            return nullptr;
-        } else {
-            return it->second;
-        }
+    ASR::symbol_t* get_symbol(std::string_view name) const {
+        SymbolIndex::Entry *e = index.find(name, SymbolIndex::hash(name));
+        if (e) return e->second;
+        if (lazy_loader) return lazy_loader->load_symbol(std::string(name));
+        return nullptr;
     }
 
     void erase_symbol(const std::string &name) {
-        //auto it = scope.find(to_lower(name));
-        LCOMPILERS_ASSERT(scope.find(name) != scope.end())
+        size_t h = SymbolIndex::hash(name);
+        LCOMPILERS_ASSERT(index.find(name, h))
+        index.erase(name, h);
         scope.erase(name);
+        mark_changed(true);
     }
 
     // Add a new symbol that did not exist before
     void add_symbol(const std::string &name, ASR::symbol_t* symbol) {
-        LCOMPILERS_ASSERT(scope.find(name) == scope.end())
-        scope[name] = symbol;
+        auto r = scope.emplace(name, symbol);
+        LCOMPILERS_ASSERT(r.second)
+        if (r.second) {
+            index.insert(&*r.first, SymbolIndex::hash(name));
+        } else {
+            r.first->second = symbol;
+        }
+        mark_changed(!r.second);
     }
 
     // Overwrite an existing symbol
     void overwrite_symbol(const std::string &name, ASR::symbol_t* symbol) {
-        LCOMPILERS_ASSERT(scope.find(name) != scope.end())
-        scope[name] = symbol;
+        LCOMPILERS_ASSERT(index.find(name, SymbolIndex::hash(name)))
+        add_or_overwrite_symbol(name, symbol);
     }
 
     // Use as the last resort, prefer to always either add a new symbol
     // or overwrite an existing one, not both
     void add_or_overwrite_symbol(const std::string &name, ASR::symbol_t* symbol) {
-        scope[name] = symbol;
+        size_t h = SymbolIndex::hash(name);
+        SymbolIndex::Entry *e = index.find(name, h);
+        if (e) {
+            e->second = symbol;
+        } else {
+            index.insert(&*scope.emplace(name, symbol).first, h);
+        }
+        mark_changed(e != nullptr);
     }
 
     // Marks all variables as external
@@ -107,6 +341,27 @@ struct SymbolTable {
     std::string get_unique_name(const std::string &name, bool use_unique_id=true);
 };
 
+// Records the changed symbol tables of the tree of `global_scope` during the
+// lifetime of the scope, see `SymbolTable::track_changes()`:
+//
+//     {
+//         ChangedScopesTracker tracker(tu->m_symtab);
+//         // Changes of the symbol tables
+//     }
+class ChangedScopesTracker {
+    SymbolTable *global_scope;
+    std::vector<SymbolTable*> changed_scopes;
+public:
+    ChangedScopesTracker(SymbolTable *global_scope) : global_scope{global_scope} {
+        global_scope->track_changes(&changed_scopes);
+    }
+    ChangedScopesTracker(const ChangedScopesTracker&) = delete;
+    ChangedScopesTracker& operator=(const ChangedScopesTracker&) = delete;
+    ~ChangedScopesTracker() {
+        global_scope->track_changes(nullptr);
+    }
+};
+
 } // namespace LCompilers
 
 #endif // LFORTRAN_SEMANTICS_ASR_SCOPES_H
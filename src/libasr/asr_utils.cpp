@@ -137,8 +137,9 @@ void extract_module_python(const ASR::TranslationUnit_t &m,
     }
 }
 
-void update_call_args(Allocator &al, SymbolTable *current_scope, bool implicit_interface,
-        std::map<std::string, ASR::symbol_t*> changed_external_function_symbol) {
+size_t update_call_args(Allocator &al, SymbolTable *current_scope, bool implicit_interface,
+        std::map<std::string, ASR::symbol_t*> &changed_external_function_symbol,
+        bool visit_all) {
     /*
         Iterate over body of program, check if there are any subroutine calls if yes, iterate over its args
         and update the args if they are equal to the old symbol
@@ -170,6 +171,7 @@ void update_call_args(Allocator &al, SymbolTable *current_scope, bool implicit_i
         Allocator &al;
         SymbolTable* scope = current_scope;
         ArgsReplacer replacer;
+        size_t n_functions = 0;
         std::map<std::string, ASR::symbol_t*> &changed_external_function_symbol;
         ArgsVisitor(Allocator &al_, std::map<std::string, ASR::symbol_t*> &changed_external_function_symbol_) : al(al_), replacer(al_),
                     changed_external_function_symbol(changed_external_function_symbol_) {}
@@ -230,9 +232,10 @@ void update_call_args(Allocator &al, SymbolTable *current_scope, bool implicit_i
 
         void visit_Function(const ASR::Function_t& x) {
             ASR::Function_t* func = (ASR::Function_t*)(&x);
+            n_functions++;
             scope = func->m_symtab;
             ASRUtils::SymbolDuplicator symbol_duplicator(al);
-            std::map<std::string, ASR::symbol_t*> scope_ = scope->get_scope();
+            auto scope_ = scope->get_scope();
             std::vector<std::string> symbols_to_duplicate;
             for (auto it: scope_) {
                 if (changed_external_function_symbol.find(it.first) != changed_external_function_symbol.end() &&
@@ -273,13 +276,48 @@ void update_call_args(Allocator &al, SymbolTable *current_scope, bool implicit_i
         }
     };
 
-    if (implicit_interface) {
-        ArgsVisitor v(al, changed_external_function_symbol);
-        SymbolTable *tu_symtab = ASRUtils::get_tu_symtab(current_scope);
+    if (!implicit_interface) return 0;
+    ArgsVisitor v(al, changed_external_function_symbol);
+    SymbolTable *tu_symtab = ASRUtils::get_tu_symtab(current_scope);
+    // A removed or replaced symbol is only referenced from the procedure
+    // that contains its symbol table, unless it is outside of procedures.
+    // Added symbols only matter for the changed external functions.
+    std::vector<ASR::symbol_t*> procedures;
+    if (tu_symtab->untracked_changes) visit_all = true;
+    for (SymbolTable *symtab : tu_symtab->get_changed_scopes()) {
+        if (!symtab->symbols_replaced && (!symtab->symbols_added
+                || changed_external_function_symbol.empty())) {
+            continue;
+        }
+        SymbolTable *s = symtab;
+        while (s && s->asr_owner && ASR::is_a<ASR::symbol_t>(*s->asr_owner)
+                && !ASR::is_a<ASR::Function_t>(*ASR::down_cast<ASR::symbol_t>(s->asr_owner))
+                && !ASR::is_a<ASR::Program_t>(*ASR::down_cast<ASR::symbol_t>(s->asr_owner))) {
+            s = s->parent;
+        }
+        if (s && s->asr_owner && ASR::is_a<ASR::symbol_t>(*s->asr_owner)) {
+            ASR::symbol_t *procedure = ASR::down_cast<ASR::symbol_t>(s->asr_owner);
+            if (std::find(procedures.begin(), procedures.end(), procedure)
+                    == procedures.end()) {
+                procedures.push_back(procedure);
+            }
+        } else if (symtab->symbols_replaced) {
+            visit_all = true;
+        }
+    }
+    if (visit_all) {
         ASR::asr_t* asr_ = tu_symtab->asr_owner;
         ASR::TranslationUnit_t* tu = ASR::down_cast2<ASR::TranslationUnit_t>(asr_);
         v.visit_TranslationUnit(*tu);
+    } else {
+        for (ASR::symbol_t *procedure : procedures) {
+            v.visit_symbol(*procedure);
+        }
     }
+    // Also clears the changes made by the walk itself, it leaves the visited
+    // procedures up to date
+    tu_symtab->clear_changed_scopes();
+    return v.n_functions;
 }
 
 ASR::Module_t* extract_module(const ASR::TranslationUnit_t &m) {
@@ -447,6 +485,16 @@ void set_intrinsic(ASR::TranslationUnit_t* trans_unit) {
     }
 }
 
+void preload_modfiles(const std::string &dir, const std::string &prefix) {
+    std::error_code ec;
+    for (auto &entry : std::filesystem::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (startswith(name, prefix) && endswith(name, ".mod")) {
+            preload_modfile(entry.path().string());
+        }
+    }
+}
+
 ASR::TranslationUnit_t* find_and_load_module(Allocator &al, const std::string &msym,
                                                 SymbolTable &symtab, bool intrinsic,
                                                 LCompilers::PassOptions& pass_options,
@@ -461,18 +509,19 @@ ASR::TranslationUnit_t* find_and_load_module(Allocator &al, const std::string &m
                           pass_options.include_dirs.begin(),
                           pass_options.include_dirs.end());
 
+    // The modfiles linked into the executable need no file system access
+    ASR::TranslationUnit_t *asr = load_embedded_modfile(al, msym, false, lm,
+        pass_options.lazy_modfiles);
     for (auto path : mod_files_dirs) {
-        std::string modfile;
+        if (asr) break;
         std::filesystem::path full_path = path / filename;
-        if (read_file(full_path.string(), modfile)) {
-            ASR::TranslationUnit_t *asr = load_modfile(al, modfile, false, symtab, lm);
-            if (intrinsic) {
-                set_intrinsic(asr);
-            }
-            return asr;
-        }
+        asr = load_modfile_from_path(al, full_path.string(), false, symtab, lm,
+            pass_options.lazy_modfiles);
     }
-    return nullptr;
+    if (asr && intrinsic) {
+        set_intrinsic(asr);
+    }
+    return asr;
 }
 
 ASR::asr_t* getStructInstanceMember_t(Allocator& al, const Location& loc,
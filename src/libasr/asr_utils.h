@@ -2290,8 +2290,15 @@ static inline bool is_external_sym_changed(ASR::symbol_t* original_sym, ASR::sym
     return !(same_number_of_args);
 }
 
-void update_call_args(Allocator &al, SymbolTable *current_scope, bool implicit_interface,
-        std::map<std::string, ASR::symbol_t*> changed_external_function_symbol);
+// Updates the arguments of calls that refer to removed or replaced symbols,
+// and the changed external functions used by procedures. Only visits the
+// procedures whose symbol tables changed since the last call (see
+// `SymbolTable::get_changed_scopes()`), or the whole translation unit if
+// `visit_all` is true, a symbol outside of procedures was replaced or the
+// changes were not recorded. Returns the number of functions visited.
+size_t update_call_args(Allocator &al, SymbolTable *current_scope, bool implicit_interface,
+        std::map<std::string, ASR::symbol_t*> &changed_external_function_symbol,
+        bool visit_all);
 
 
 ASR::Module_t* extract_module(const ASR::TranslationUnit_t &m);
@@ -2310,6 +2317,10 @@ ASR::TranslationUnit_t* find_and_load_module(Allocator &al, const std::string &m
                                                 LCompilers::PassOptions& pass_options,
                                                 LCompilers::LocationManager &lm);
 
+// Reads all modfiles `<prefix>*.mod` in `dir` into the process wide modfile
+// cache (used by long running compiler processes)
+void preload_modfiles(const std::string &dir, const std::string &prefix);
+
 void set_intrinsic(ASR::TranslationUnit_t* trans_unit);
 
 static inline bool is_const(ASR::expr_t *x) {
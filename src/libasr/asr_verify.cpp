@@ -111,7 +111,7 @@ public:
         require(down_cast2<TranslationUnit_t>(current_symtab->asr_owner)->m_symtab == current_symtab,
             "The asr_owner invariant failed");
         id_symtab_map[x.m_symtab->counter] = x.m_symtab;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         for (size_t i=0; i<x.n_items; i++) {
@@ -165,7 +165,7 @@ public:
             std::string(x.m_name) + "::m_dependencies is required");
         }
         id_symtab_map[x.m_symtab->counter] = x.m_symtab;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         for (size_t i=0; i<x.n_body; i++) {
@@ -189,7 +189,7 @@ public:
         require(ASRUtils::symbol_symtab(down_cast<symbol_t>(current_symtab->asr_owner)) == current_symtab,
             "The asr_owner invariant failed");
         id_symtab_map[x.m_symtab->counter] = x.m_symtab;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         for (size_t i=0; i<x.n_body; i++) {
@@ -236,7 +236,7 @@ public:
         require(ASRUtils::symbol_symtab(down_cast<symbol_t>(current_symtab->asr_owner)) == current_symtab,
             "The asr_owner invariant failed");
         id_symtab_map[x.m_symtab->counter] = x.m_symtab;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         for (size_t i=0; i<x.n_body; i++) {
@@ -259,7 +259,7 @@ public:
         require(ASRUtils::symbol_symtab(down_cast<symbol_t>(current_symtab->asr_owner)) == current_symtab,
             "The asr_owner invariant failed");
         id_symtab_map[x.m_symtab->counter] = x.m_symtab;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -279,7 +279,7 @@ public:
         require(ASRUtils::symbol_symtab(down_cast<symbol_t>(current_symtab->asr_owner)) == current_symtab,
             "The asr_owner invariant failed");
         id_symtab_map[x.m_symtab->counter] = x.m_symtab;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -333,7 +333,7 @@ public:
         require(ASRUtils::symbol_symtab(down_cast<symbol_t>(current_symtab->asr_owner)) == current_symtab,
             "The asr_owner invariant failed");
         id_symtab_map[x.m_symtab->counter] = x.m_symtab;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
 
@@ -449,7 +449,7 @@ public:
         require(x.m_function_signature,
                     "Type signature is required for `" + func_name + "`");
         id_symtab_map[x.m_symtab->counter] = x.m_symtab;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             LCOMPILERS_ASSERT(a.second);
             this->visit_symbol(*a.second);
         }
@@ -526,7 +526,7 @@ public:
             "The asr_owner invariant failed");
         id_symtab_map[x.m_symtab->counter] = x.m_symtab;
         std::vector<std::string> struct_dependencies;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
             if( ASR::is_a<ASR::ClassProcedure_t>(*a.second) ||
                 ASR::is_a<ASR::GenericProcedure_t>(*a.second) ||
@@ -595,7 +595,7 @@ public:
             std::string(x.m_name) + " doesn't seem to follow this rule.");
         ASR::ttype_t* common_type = x.m_type;
         std::map<int64_t, int64_t> value2count;
-        for( auto itr: x.m_symtab->get_scope() ) {
+        for( auto itr: x.m_symtab->get_loaded_scope() ) {
             ASR::Variable_t* itr_var = ASR::down_cast<ASR::Variable_t>(itr.second);
             require(itr_var->m_symbolic_value != nullptr,
                 "All members of EnumType must have their values to be set. " +
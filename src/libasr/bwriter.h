@@ -1,6 +1,7 @@
 #ifndef LFORTRAN_BWRITER_H
 #define LFORTRAN_BWRITER_H
 
+#include <cstring>
 #include <sstream>
 #include <iomanip>
 
@@ -120,6 +121,11 @@ static inline void* string_to_void(const char *s) {
 
 // BinaryReader / BinaryWriter encapsulate access to the file by providing
 // primitives that other classes just use.
+//
+// Strings are stored with a terminating '\0' and raw data (`write_void`) is
+// aligned to 8 bytes, so that a reader of a buffer that outlives the
+// deserialized objects (such as a memory mapped modfile) can reference them
+// in place instead of copying them.
 class BinaryWriter
 {
 private:
@@ -129,6 +135,11 @@ public:
         return s;
     }
 
+    // Number of bytes written so far
+    size_t size() const {
+        return s.size();
+    }
+
     void write_int8(uint8_t i) {
         char c=i;
         s.append(std::string(&c, 1));
@@ -149,6 +160,12 @@ public:
     void write_string(const std::string &t) {
         write_int64(t.size());
         s.append(t);
+        s.push_back('\0');
+    }
+
+    // Pads with zeros to a multiple of `alignment` bytes
+    void align(size_t alignment) {
+        s.append((alignment - s.size() % alignment) % alignment, '\0');
     }
 
     void write_float64(double d) {
@@ -162,10 +179,8 @@ public:
     }
 
     void write_void(void *p, int64_t n_data) {
-        for (int64_t i = 0; i < n_data; i++) {
-            uint8_t* p_i8 = (uint8_t*)p;
-            write_int8(p_i8[i]);
-        }
+        align(8);
+        s.append((const char*)p, n_data);
     }
 
 };
@@ -173,55 +188,83 @@ public:
 class BinaryReader
 {
 private:
-    std::string s;
+    // The buffer is either a copy owned by the reader (`storage`) or a view
+    // of a buffer owned by the caller
+    std::string storage;
+    const char *s;
+    size_t s_size;
     size_t pos;
+
+    void check_size(size_t n, const char *fn) {
+        if (pos+n > s_size) {
+            throw LCompilersException(std::string(fn)
+                + ": String is too short for deserialization.");
+        }
+    }
 public:
-    BinaryReader(const std::string &s) : s{s}, pos{0} {}
+    BinaryReader(const std::string &s) : storage{s}, s{storage.data()},
+        s_size{storage.size()}, pos{0} {}
+    BinaryReader(const char *data, size_t size) : s{data}, s_size{size},
+        pos{0} {}
+    BinaryReader(const BinaryReader &) = delete;
+    BinaryReader& operator=(const BinaryReader &) = delete;
+
+    size_t get_pos() const {
+        return pos;
+    }
+
+    // Continue reading at `new_pos` (a position returned by `get_pos()` or
+    // the writer's `size()`)
+    void set_pos(size_t new_pos) {
+        pos = new_pos;
+    }
 
     uint8_t read_int8() {
-        if (pos+1 > s.size()) {
-            throw LCompilersException("read_int8: String is too short for deserialization.");
-        }
+        check_size(1, "read_int8");
         uint8_t n = s[pos];
         pos += 1;
         return n;
     }
 
     uint16_t read_int16() {
-        if (pos+2 > s.size()) {
-            throw LCompilersException("read_int16: String is too short for deserialization.");
-        }
-        uint16_t n = string_to_uint16(&s[pos]);
+        check_size(2, "read_int16");
+        uint16_t n = string_to_uint16(s + pos);
         pos += 2;
         return n;
     }
 
     uint32_t read_int32() {
-        if (pos+4 > s.size()) {
-            throw LCompilersException("read_int32: String is too short for deserialization.");
-        }
-        uint32_t n = string_to_uint32(&s[pos]);
+        check_size(4, "read_int32");
+        uint32_t n = string_to_uint32(s + pos);
         pos += 4;
         return n;
     }
 
     uint64_t read_int64() {
-        if (pos+8 > s.size()) {
-            throw LCompilersException("read_int64: String is too short for deserialization.");
-        }
-        uint64_t n = string_to_uint64(&s[pos]);
+        check_size(8, "read_int64");
+        uint64_t n = string_to_uint64(s + pos);
         pos += 8;
         return n;
     }
 
     std::string read_string() {
-        size_t n = read_int64();
-        if (pos+n > s.size()) {
-            throw LCompilersException("read_string: String is too short for deserialization.");
-        }
-        std::string r = std::string(&s[pos], n);
-        pos += n;
-        return r;
+        size_t n;
+        const char *p = read_string_in_place(n);
+        return std::string(p, n);
+    }
+
+    // Returns the '\0' terminated string in the buffer without copying it
+    const char* read_string_in_place(size_t &n) {
+        n = read_int64();
+        check_size(n+1, "read_string");
+        const char *p = s + pos;
+        pos += n+1;
+        return p;
+    }
+
+    // Skips the padding written by `BinaryWriter::align()`
+    void align(size_t alignment) {
+        pos += (alignment - pos % alignment) % alignment;
     }
 
     double read_float64() {
@@ -233,16 +276,19 @@ public:
     }
 
     void* read_void(int64_t n_data) {
+        const void *data = read_void_in_place(n_data);
         void *p = new char[n_data];
+        std::memcpy(p, data, n_data);
+        return p;
+    }
 
-        for (int64_t i = 0; i < n_data; i++) {
-            uint8_t x = read_int8();
-            uint8_t *ip = &x;
-            void *p_i = (void*)((uintptr_t)p + i);
-            uint8_t *p_i_8 = (uint8_t*)p_i;
-            *p_i_8 = *ip;
-        }
-
+    // Returns the data in the buffer without copying it, it is aligned to 8
+    // bytes if the buffer is
+    const void* read_void_in_place(int64_t n_data) {
+        align(8);
+        check_size(n_data, "read_void");
+        const void *p = s + pos;
+        pos += n_data;
         return p;
     }
 };
@@ -259,6 +305,11 @@ public:
         return s;
     }
 
+    // Number of bytes written so far
+    size_t size() const {
+        return s.size();
+    }
+
     void write_int8(uint8_t i) {
         s.append(std::to_string(i));
         s += " ";
@@ -285,6 +336,9 @@ public:
         s += " ";
     }
 
+    // The text format is not aligned
+    void align(size_t /*alignment*/) {}
+
     void write_float64(double d) {
         std::stringstream str;
         str << std::fixed << std::setprecision(17) << d;
@@ -313,6 +367,17 @@ private:
     size_t pos;
 public:
     TextReader(const std::string &s) : s{s}, pos{0} {}
+    TextReader(const char *data, size_t size) : s{data, size}, pos{0} {}
+
+    size_t get_pos() const {
+        return pos;
+    }
+
+    // Continue reading at `new_pos` (a position returned by `get_pos()` or
+    // the writer's `size()`)
+    void set_pos(size_t new_pos) {
+        pos = new_pos;
+    }
 
     uint8_t read_int8() {
         uint64_t n = read_int64();
@@ -386,6 +451,8 @@ public:
         return r;
     }
 
+    void align(size_t /*alignment*/) {}
+
     void* read_void(int64_t n_data) {
         void *p = new char[n_data];
 
@@ -280,7 +280,7 @@ namespace LCompilers {
         if( name2dertype.find(union_type_name) != name2dertype.end() ) {
             union_type_llvm = name2dertype[union_type_name];
         } else {
-            const std::map<std::string, ASR::symbol_t*>& scope = union_type->m_symtab->get_scope();
+            const auto &scope = union_type->m_symtab->get_scope();
             llvm::DataLayout data_layout(module->getDataLayout());
             llvm::Type* max_sized_type = nullptr;
             size_t max_type_size = 0;
@@ -310,7 +310,7 @@ namespace LCompilers {
     }
 
     llvm::Type* LLVMUtils::getClassType(ASR::Class_t* der_type, bool is_pointer) {
-        const std::map<std::string, ASR::symbol_t*>& scope = der_type->m_symtab->get_scope();
+        const auto &scope = der_type->m_symtab->get_scope();
         std::vector<llvm::Type*> member_types;
         int member_idx = 0;
         for( auto itr = scope.begin(); itr != scope.end(); itr++ ) {
@@ -8,6 +8,8 @@
 
 namespace LCompilers::diag {
 
+std::atomic<bool> capture_stacktraces{false};
+
 const static std::string redon  = ColorsANSI::RED;
 const static std::string redoff = ColorsANSI::RESET;
 
@@ -158,7 +160,7 @@ void populate_spans(diag::Diagnostic &d, const LocationManager &lm) {
 std::string render_diagnostic_human(Diagnostic &d, const LocationManager &lm,
         bool use_colors, bool show_stacktrace) {
     std::string out;
-    if (show_stacktrace) {
+    if (show_stacktrace && !d.stacktrace.empty()) {
         out += error_stacktrace(d.stacktrace);
     }
     // Convert to line numbers and get source code strings
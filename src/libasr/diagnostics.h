@@ -1,6 +1,7 @@
 #ifndef LFORTRAN_DIAGNOSTICS_H
 #define LFORTRAN_DIAGNOSTICS_H
 
+#include <atomic>
 #include <tuple>
 #include <libasr/location.h>
 #include <libasr/stacktrace.h>
@@ -12,6 +13,18 @@ struct CompilerOptions;
 
 namespace diag {
 
+// If true, every Diagnostic records the stacktrace of the place where it was
+// created (`--show-stacktrace`). Capturing unwinds the stack, which is too
+// expensive to do for every warning and style suggestion otherwise.
+extern std::atomic<bool> capture_stacktraces;
+
+inline std::vector<StacktraceItem> diagnostic_stacktrace() {
+    if (capture_stacktraces.load(std::memory_order_relaxed)) {
+        return get_stacktrace_addresses();
+    }
+    return {};
+}
+
 struct Span {
     Location loc; // Linear location (span), must be filled out
 
@@ -101,7 +114,8 @@ struct Diagnostic {
     std::string message;
     std::vector<Label> labels;
     std::vector<Diagnostic> children;
-    std::vector<StacktraceItem> stacktrace = get_stacktrace_addresses();
+    // Empty unless `capture_stacktraces` is set
+    std::vector<StacktraceItem> stacktrace = diagnostic_stacktrace();
 
     Diagnostic(const std::string &message, const Level &level,
         const Stage &stage) : level{level}, stage{stage}, message{message} {}
@@ -2,6 +2,7 @@
 #define LFORTRAN_PARSER_LOCATION_H
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 namespace LCompilers {
@@ -28,6 +29,68 @@ static inline uint32_t bisection(const std::vector<uint32_t> &vec, uint32_t i) {
     return i1+1;
 }
 
+// Same as `bisection`, but first tries the interval `hint` and the one after
+// it, and stores the result in `hint`. Consecutive lookups of increasing
+// positions (rendering of diagnostics, LSP requests) are then O(1).
+static inline uint32_t bisection(const std::vector<uint32_t> &vec, uint32_t i,
+        uint32_t &hint) {
+    uint32_t n = vec.size();
+    for (uint32_t k = hint; k <= hint+1 && k <= n; k++) {
+        if ((k == 0 || vec[k-1] <= i) && (k == n || i < vec[k])) {
+            hint = k;
+            return k;
+        }
+    }
+    hint = bisection(vec, i);
+    return hint;
+}
+
+// Compact encoding of a vector of positions, used in modfiles: every element
+// is stored as the difference to the previous element (zigzag encoded, as the
+// vector is not required to be sorted) in a LEB128 varint. Positions of
+// newlines and interval starts then take one or two bytes instead of four.
+static inline std::string encode_positions(const std::vector<uint32_t> &vec) {
+    std::string s;
+    s.reserve(vec.size()*2);
+    uint32_t prev = 0;
+    for (uint32_t x : vec) {
+        int64_t d = (int64_t)x - (int64_t)prev;
+        uint64_t z = d < 0 ? ((uint64_t)(-d) << 1) - 1 : (uint64_t)d << 1;
+        while (z >= 0x80) {
+            s.push_back((char)(z | 0x80));
+            z >>= 7;
+        }
+        s.push_back((char)z);
+        prev = x;
+    }
+    return s;
+}
+
+// Inverse of `encode_positions`, returns false if `s` is malformed
+static inline bool decode_positions(const std::string &s,
+        std::vector<uint32_t> &vec) {
+    vec.clear();
+    uint32_t prev = 0;
+    size_t pos = 0;
+    while (pos < s.size()) {
+        uint64_t z = 0;
+        unsigned shift = 0;
+        uint8_t c;
+        do {
+            if (pos >= s.size() || shift >= 35) return false;
+            c = s[pos++];
+            z |= (uint64_t)(c & 0x7f) << shift;
+            shift += 7;
+        } while (c & 0x80);
+        int64_t d = (z & 1) ? -(int64_t)((z + 1) >> 1) : (int64_t)(z >> 1);
+        int64_t x = (int64_t)prev + d;
+        if (x < 0 || x > UINT32_MAX) return false;
+        prev = x;
+        vec.push_back(prev);
+    }
+    return true;
+}
+
 struct LocationManager {
     // The index into these vectors is the interval ID, starting from 0
     //
@@ -131,7 +194,9 @@ struct LocationManager {
         uint32_t index = bisection(file_ends, out_pos);
         if (index != 0 && index == file_ends.size()) index -= 1;
         if (files[index].out_start.size() == 0) return 0;
-        uint32_t interval = bisection(files[index].out_start, out_pos)-1;
+        static thread_local uint32_t interval_hint = 0;
+        uint32_t interval = bisection(files[index].out_start, out_pos,
+            interval_hint)-1;
         uint32_t rel_pos = out_pos - files[index].out_start[interval];
         uint32_t in_pos = files[index].in_start[interval] + rel_pos;
         if (files[index].preprocessor) {
@@ -201,14 +266,10 @@ struct LocationManager {
     uint64_t linecol_to_pos(uint16_t line, uint16_t col) {
         // use in_newlines and compute pos
         uint64_t pos = 0;
-        uint64_t l = 1;
-        while(true) {
-            if (l == line) break;
-            if (l >= files[0].in_newlines.size()) return 0;
-            l++;
+        if (line == 0 || (line > 1 && line-1u >= files[0].in_newlines.size())) {
+            return 0;
         }
-        if ( l == 1 ) pos = 0;
-        else pos = files[0].in_newlines[l-2];
+        if (line > 1) pos = files[0].in_newlines[line-2];
         pos = pos + col;
         return pos;
     }
@@ -231,7 +292,10 @@ struct LocationManager {
         } else {
             newlines = &files[index].in_newlines;
         }
-        int32_t interval = bisection(*newlines, position);
+        // Diagnostics and LSP requests usually look up nearby positions one
+        // after another, so the line found last is tried first
+        static thread_local uint32_t line_hint = 0;
+        int32_t interval = bisection(*newlines, position, line_hint);
         if (interval >= 1 && position == (*newlines)[interval-1]) {
             // position is exactly the \n character, make sure `line` is
             // the line with \n, and `col` points to the position of \n
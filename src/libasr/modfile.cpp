@@ -1,4 +1,16 @@
 #include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <filesystem>
+#include <fstream>
+
+#if !defined(_WIN32) && !defined(HAVE_BUILD_TO_WASM)
+#define HAVE_LFORTRAN_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include <libasr/config.h>
 #include <libasr/asr_utils.h>
@@ -10,8 +22,24 @@
 namespace LCompilers {
 
 const std::string lfortran_modfile_type_string = "LCompilers Modfile";
+// Increment when the layout of the modfile changes
+const uint32_t lfortran_modfile_format_version = 5;
+
+// The position vectors of the LocationManager are stored delta and varint
+// encoded (see `encode_positions`)
+template <class Writer>
+void write_positions(Writer &b, const std::vector<uint32_t> &v) {
+    b.write_string(encode_positions(v));
+}
+
+template <class Reader>
+void read_positions(Reader &b, std::vector<uint32_t> &v) {
+    if (!decode_positions(b.read_string(), v)) {
+        throw LCompilersException("LCompilers Modfile: corrupted location information");
+    }
+}
 
-inline void save_asr(const ASR::TranslationUnit_t &m, std::string& asr_string, LCompilers::LocationManager lm) {
+inline void save_asr(const ASR::TranslationUnit_t &m, std::string& asr_string, const LCompilers::LocationManager &lm) {
     #ifdef WITH_LFORTRAN_BINARY_MODFILES
     BinaryWriter b;
 #else
@@ -20,6 +48,11 @@ inline void save_asr(const ASR::TranslationUnit_t &m, std::string& asr_string, L
     // Header
     b.write_string(lfortran_modfile_type_string);
     b.write_string(LFORTRAN_VERSION);
+    b.write_int32(lfortran_modfile_format_version);
+    // Hash of the module and the lines and columns of its code (see
+    // `structural_hash()`), used as the key of the module by the compilation
+    // cache
+    b.write_int64(structural_hash((const ASR::asr_t&)m, &lm));
 
     // AST section: Original module source code:
     // Currently empty.
@@ -35,72 +68,60 @@ inline void save_asr(const ASR::TranslationUnit_t &m, std::string& asr_string, L
 
     // Full LocationManager:
     b.write_int32(lm.files.size());
-    for(auto file: lm.files) {
+    for(auto &file: lm.files) {
         // std::vector<FileLocations> files;
         b.write_string(file.in_filename);
         b.write_int32(file.current_line);
 
         // std::vector<uint32_t> out_start
-        b.write_int32(file.out_start.size());
-        for(auto i: file.out_start) {
-            b.write_int32(i);
-        }
+        write_positions(b, file.out_start);
 
         // std::vector<uint32_t> in_start
-        b.write_int32(file.in_start.size());
-        for(auto i: file.in_start) {
-            b.write_int32(i);
-        }
+        write_positions(b, file.in_start);
 
         // std::vector<uint32_t> in_newlines
-        b.write_int32(file.in_newlines.size());
-        for(auto i: file.in_newlines) {
-            b.write_int32(i);
-        }
+        write_positions(b, file.in_newlines);
 
         // bool preprocessor
         b.write_int32(file.preprocessor);
 
         // std::vector<uint32_t> out_start0
-        b.write_int32(file.out_start0.size());
-        for(auto i: file.out_start0) {
-            b.write_int32(i);
-        }
+        write_positions(b, file.out_start0);
 
         // std::vector<uint32_t> in_start0
-        b.write_int32(file.in_start0.size());
-        for(auto i: file.in_start0) {
-            b.write_int32(i);
-        }
+        write_positions(b, file.in_start0);
 
         // std::vector<uint32_t> in_size0
-        b.write_int32(file.in_size0.size());
-        for(auto i: file.in_size0) {
-            b.write_int32(i);
-        }
+        write_positions(b, file.in_size0);
 
         // std::vector<uint32_t> interval_type0
-        b.write_int32(file.interval_type0.size());
-        for(auto i: file.interval_type0) {
-            b.write_int32(i);
-        }
+        write_positions(b, file.interval_type0);
 
         // std::vector<uint32_t> in_newlines0
-        b.write_int32(file.in_newlines0.size());
-        for(auto i: file.in_newlines0) {
-            b.write_int32(i);
-        }
+        write_positions(b, file.in_newlines0);
     }
 
     // std::vector<uint32_t> file_ends
-    b.write_int32(lm.file_ends.size());
-    for(auto i: lm.file_ends) {
-        b.write_int32(i);
+    write_positions(b, lm.file_ends);
+
+    // Full ASR, aligned so that it can be used in place when the modfile is
+    // mapped into memory:
+    std::vector<SymbolIndexEntry> index;
+    b.align(8);
+    b.write_string(serialize(m, index));
+
+    // Symbol index: the positions of the module level symbols in the ASR
+    b.write_int32(index.size());
+    for (auto &entry : index) {
+        b.write_string(entry.name);
+        b.write_int64(entry.start);
+        b.write_int64(entry.end);
+        b.write_int32(entry.symtab_ids.size());
+        for (auto id : entry.symtab_ids) {
+            b.write_int64(id);
+        }
     }
 
-    // Full ASR:
-    b.write_string(serialize(m));
-
     asr_string = b.get_str();
 }
 
@@ -134,12 +155,75 @@ std::string save_pycfile(const ASR::TranslationUnit_t &m, LCompilers::LocationMa
     return asr_string;
 }
 
-inline void load_serialised_asr(const std::string &s, std::string& asr_binary,
-                                LCompilers::LocationManager &lm) {
+// The contents of a modfile. It is mapped into memory if possible, so that
+// only the pages that are used are read from the disk.
+class ModfileBuffer {
+public:
+    const char *data = nullptr;
+    size_t size = 0;
+
+    ModfileBuffer() = default;
+    ModfileBuffer(const ModfileBuffer &) = delete;
+    ModfileBuffer& operator=(const ModfileBuffer &) = delete;
+
+    bool load(const std::string &path) {
+#ifdef HAVE_LFORTRAN_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        off_t file_size = lseek(fd, 0, SEEK_END);
+        if (file_size > 0) {
+            // A read only mapping: the ASR that points into it is never
+            // modified in place
+            void *p = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                mapping = p;
+                data = (const char*)p;
+                size = file_size;
+            }
+        }
+        close(fd);
+        if (mapping) return true;
+#endif
+        if (!read_file(path, storage)) return false;
+        data = storage.data();
+        size = storage.size();
+        return true;
+    }
+
+    ~ModfileBuffer() {
+#ifdef HAVE_LFORTRAN_MMAP
+        if (mapping) munmap(mapping, size);
+#endif
+    }
+
+private:
+    void *mapping = nullptr;
+    std::string storage;
+};
+
+// The decoded contents of a modfile: the locations of its source file and the
+// serialized ASR
+struct DecodedModfile {
+    uint64_t asr_hash;
+    LCompilers::LocationManager::FileLocations file;
+    uint32_t file_end;
+    // The serialized ASR, it points into `buffer` (or into an embedded
+    // modfile or the string passed to `load_modfile`)
+    const char *asr_data;
+    size_t asr_size;
+    std::vector<SymbolIndexEntry> symbol_index;
+    ModfileBuffer buffer;
+#ifndef WITH_LFORTRAN_BINARY_MODFILES
+    std::string asr_storage;
+#endif
+};
+
+inline void decode_serialised_asr(const char *data, size_t size,
+        DecodedModfile &m) {
 #ifdef WITH_LFORTRAN_BINARY_MODFILES
-    BinaryReader b(s);
+    BinaryReader b(data, size);
 #else
-    TextReader b(s);
+    TextReader b(data, size);
 #endif
     std::string file_type = b.read_string();
     if (file_type != lfortran_modfile_type_string) {
@@ -149,6 +233,11 @@ inline void load_serialised_asr(const std::string &s, std::string& asr_binary,
     if (version != LFORTRAN_VERSION) {
         throw LCompilersException("Incompatible format: LFortran Modfile was generated using version '" + version + "', but current LFortran version is '" + LFORTRAN_VERSION + "'");
     }
+    uint32_t format_version = b.read_int32();
+    if (format_version != lfortran_modfile_format_version) {
+        throw LCompilersException("Incompatible format: LFortran Modfile has the format version " + std::to_string(format_version) + ", expected " + std::to_string(lfortran_modfile_format_version));
+    }
+    m.asr_hash = b.read_int64();
     LCompilers::LocationManager serialized_lm;
     int32_t n_files = b.read_int32();
     std::vector<LCompilers::LocationManager::FileLocations> files;
@@ -157,79 +246,247 @@ inline void load_serialised_asr(const std::string &s, std::string& asr_binary,
         file.in_filename = b.read_string();
         file.current_line = b.read_int32();
 
-        int32_t n_out_start = b.read_int32();
-        for(int i=0; i<n_out_start; i++) {
-            file.out_start.push_back(b.read_int32());
-        }
+        read_positions(b, file.out_start);
 
-        int32_t n_in_start = b.read_int32();
-        for(int i=0; i<n_in_start; i++) {
-            file.in_start.push_back(b.read_int32());
-        }
+        read_positions(b, file.in_start);
 
-        int32_t n_in_newlines = b.read_int32();
-        for(int i=0; i<n_in_newlines; i++) {
-            file.in_newlines.push_back(b.read_int32());
-        }
+        read_positions(b, file.in_newlines);
 
         file.preprocessor = b.read_int32();
 
-        int32_t n_out_start0 = b.read_int32();
-        for(int i=0; i<n_out_start0; i++) {
-            file.out_start0.push_back(b.read_int32());
-        }
+        read_positions(b, file.out_start0);
 
-        int32_t n_in_start0 = b.read_int32();
-        for(int i=0; i<n_in_start0; i++) {
-            file.in_start0.push_back(b.read_int32());
-        }
+        read_positions(b, file.in_start0);
 
-        int32_t n_in_size0 = b.read_int32();
-        for(int i=0; i<n_in_size0; i++) {
-            file.in_size0.push_back(b.read_int32());
-        }
+        read_positions(b, file.in_size0);
 
-        int32_t n_interval_type0 = b.read_int32();
-        for(int i=0; i<n_interval_type0; i++) {
-            file.interval_type0.push_back(b.read_int32());
-        }
+        read_positions(b, file.interval_type0);
 
-        int32_t n_in_newlines0 = b.read_int32();
-        for(int i=0; i<n_in_newlines0; i++) {
-            file.in_newlines0.push_back(b.read_int32());
-        }
+        read_positions(b, file.in_newlines0);
 
         serialized_lm.files.push_back(file);
     }
 
-    int32_t n_file_ends = b.read_int32();
-    for(int i=0; i<n_file_ends; i++) {
-        serialized_lm.file_ends.push_back(b.read_int32());
-    }
+    read_positions(b, serialized_lm.file_ends);
 
-    lm.files.push_back(serialized_lm.files[0]);
-    lm.file_ends.push_back(serialized_lm.file_ends[0] + lm.file_ends.back());
+    m.file = serialized_lm.files[0];
+    m.file_end = serialized_lm.file_ends[0];
+    b.align(8);
+#ifdef WITH_LFORTRAN_BINARY_MODFILES
+    m.asr_data = b.read_string_in_place(m.asr_size);
+#else
+    m.asr_storage = b.read_string();
+    m.asr_data = m.asr_storage.data();
+    m.asr_size = m.asr_storage.size();
+#endif
 
-    asr_binary = b.read_string();
+    int32_t n_symbols = b.read_int32();
+    for (int i=0; i<n_symbols; i++) {
+        SymbolIndexEntry entry;
+        entry.name = b.read_string();
+        entry.start = b.read_int64();
+        entry.end = b.read_int64();
+        int32_t n_symtab_ids = b.read_int32();
+        for (int j=0; j<n_symtab_ids; j++) {
+            entry.symtab_ids.push_back(b.read_int64());
+        }
+        m.symbol_index.push_back(entry);
+    }
 }
 
-ASR::TranslationUnit_t* load_modfile(Allocator &al, const std::string &s,
-        bool load_symtab_id, SymbolTable &symtab, LCompilers::LocationManager &lm) {
-    std::string asr_binary;
-    load_serialised_asr(s, asr_binary, lm);
+inline void add_file_locations(const DecodedModfile &m,
+        LCompilers::LocationManager &lm) {
+    lm.files.push_back(m.file);
+    lm.file_ends.push_back(m.file_end + lm.file_ends.back());
+}
+
+// If `in_place` is true, the modfile must outlive the allocator `al`
+inline ASR::TranslationUnit_t* load_decoded_modfile(Allocator &al,
+        const DecodedModfile &m, bool load_symtab_id,
+        LCompilers::LocationManager &lm, bool lazy, bool in_place) {
+    add_file_locations(m, lm);
     // take offset as last second element of file_ends
     uint32_t offset = lm.file_ends[lm.file_ends.size()-2];
-    ASR::asr_t *asr = deserialize_asr(al, asr_binary, load_symtab_id, symtab, offset);
+    ASR::asr_t *asr;
+    if (lazy && in_place && !m.symbol_index.empty()) {
+        asr = deserialize_asr_lazy(al, m.asr_data, m.asr_size, m.symbol_index,
+            load_symtab_id, offset);
+    } else {
+        asr = deserialize_asr(al, m.asr_data, m.asr_size, load_symtab_id,
+            offset, in_place);
+    }
     ASR::TranslationUnit_t *tu = ASR::down_cast2<ASR::TranslationUnit_t>(asr);
     return tu;
 }
 
+ASR::TranslationUnit_t* load_modfile(Allocator &al, const std::string &s,
+        bool load_symtab_id, SymbolTable & /*symtab*/,
+        LCompilers::LocationManager &lm) {
+    DecodedModfile m;
+    decode_serialised_asr(s.data(), s.size(), m);
+    return load_decoded_modfile(al, m, load_symtab_id, lm, false, false);
+}
+
+/*
+    Process wide read cache of modfiles, keyed by path. It holds the bytes of
+    the file and its decoded header, not the deserialized ASR.
+
+    An entry is reused as long as the size and the modification time of the
+    file are unchanged, so a modfile is read only once per process. Every
+    load still deserializes into the caller's allocator and symbol table,
+    because `load_module` and the ASR passes modify the loaded modules in
+    place (use `lazy` to deserialize only the symbols that are used).
+
+    The identifiers and constant arrays of the loaded ASR point into the
+    modfile, so every allocator that a modfile is loaded into keeps it alive
+    (see `Allocator::keep`). An entry that is replaced by a newer version of
+    the file is unmapped once the last allocator that uses it is destroyed.
+*/
+struct ModfileCacheEntry {
+    uintmax_t size;
+    std::filesystem::file_time_type mtime;
+    std::shared_ptr<const DecodedModfile> modfile;
+};
+
+static std::mutex modfile_cache_mutex;
+static std::map<std::string, ModfileCacheEntry> modfile_cache;
+static ModfileReadCacheStats modfile_read_cache_stats;
+
+static std::shared_ptr<const DecodedModfile> get_cached_modfile(
+        const std::string &path) {
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec) return nullptr;
+    std::filesystem::file_time_type mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return nullptr;
+    {
+        std::lock_guard<std::mutex> lock(modfile_cache_mutex);
+        auto it = modfile_cache.find(path);
+        if (it != modfile_cache.end() && it->second.size == size
+                && it->second.mtime == mtime) {
+            modfile_read_cache_stats.hits++;
+            return it->second.modfile;
+        }
+    }
+    std::shared_ptr<DecodedModfile> m = std::make_shared<DecodedModfile>();
+    if (!m->buffer.load(path)) return nullptr;
+    decode_serialised_asr(m->buffer.data, m->buffer.size, *m);
+    std::lock_guard<std::mutex> lock(modfile_cache_mutex);
+    modfile_read_cache_stats.misses++;
+    modfile_cache[path] = {size, mtime, m};
+    return m;
+}
+
+ASR::TranslationUnit_t* load_modfile_from_path(Allocator &al,
+        const std::string &path, bool load_symtab_id, SymbolTable & /*symtab*/,
+        LCompilers::LocationManager &lm, bool lazy) {
+    std::shared_ptr<const DecodedModfile> m = get_cached_modfile(path);
+    if (!m) return nullptr;
+    al.keep(m);
+    return load_decoded_modfile(al, *m, load_symtab_id, lm, lazy, true);
+}
+
+bool modfile_asr_hash(const std::string &path, uint64_t &hash) {
+    std::shared_ptr<const DecodedModfile> m;
+    try {
+        m = get_cached_modfile(path);
+    } catch (const LCompilersException &) {
+        return false;
+    }
+    if (!m) return false;
+    hash = m->asr_hash;
+    return true;
+}
+
+bool write_modfile(const std::string &path, const std::string &modfile) {
+    // Write to a temporary file and rename it, so that the modfile is
+    // replaced atomically: other compiler processes may have the previous
+    // version mapped into memory
+    std::string tmp_path = path + ".tmp";
+#ifdef HAVE_LFORTRAN_MMAP
+    tmp_path += std::to_string(getpid());
+#endif
+    {
+        std::ofstream out(tmp_path, std::ofstream::out | std::ofstream::binary);
+        out << modfile;
+        if (!out.good()) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+/*
+    Modfiles linked into the executable. They are registered during static
+    initialization and decoded on first use, so loading them needs no file
+    system access at all.
+*/
+struct EmbeddedModfileEntry {
+    const EmbeddedModfile *modfile;
+    std::shared_ptr<const DecodedModfile> decoded;
+};
+
+// A function local static, because the registration runs during static
+// initialization of another translation unit
+static std::map<std::string, EmbeddedModfileEntry>& get_embedded_modfiles() {
+    static std::map<std::string, EmbeddedModfileEntry> embedded_modfiles;
+    return embedded_modfiles;
+}
+
+bool register_embedded_modfiles(const EmbeddedModfile *modfiles, size_t n) {
+    std::lock_guard<std::mutex> lock(modfile_cache_mutex);
+    for (size_t i = 0; i < n; i++) {
+        get_embedded_modfiles()[modfiles[i].name] = {&modfiles[i], nullptr};
+    }
+    return true;
+}
+
+ASR::TranslationUnit_t* load_embedded_modfile(Allocator &al,
+        const std::string &name, bool load_symtab_id,
+        LCompilers::LocationManager &lm, bool lazy) {
+    std::shared_ptr<const DecodedModfile> m;
+    {
+        std::lock_guard<std::mutex> lock(modfile_cache_mutex);
+        std::map<std::string, EmbeddedModfileEntry> &embedded_modfiles
+            = get_embedded_modfiles();
+        auto it = embedded_modfiles.find(name);
+        if (it == embedded_modfiles.end()) return nullptr;
+        if (it->second.decoded) {
+            modfile_read_cache_stats.hits++;
+        } else {
+            std::shared_ptr<DecodedModfile> decoded
+                = std::make_shared<DecodedModfile>();
+            decode_serialised_asr(it->second.modfile->data,
+                it->second.modfile->size, *decoded);
+            it->second.decoded = decoded;
+            modfile_read_cache_stats.misses++;
+        }
+        m = it->second.decoded;
+    }
+    return load_decoded_modfile(al, *m, load_symtab_id, lm, lazy, true);
+}
+
+bool preload_modfile(const std::string &path) {
+    return get_cached_modfile(path) != nullptr;
+}
+
+ModfileReadCacheStats get_modfile_read_cache_stats() {
+    std::lock_guard<std::mutex> lock(modfile_cache_mutex);
+    return modfile_read_cache_stats;
+}
+
 ASR::TranslationUnit_t* load_pycfile(Allocator &al, const std::string &s,
         bool load_symtab_id, LCompilers::LocationManager &lm) {
-    std::string asr_binary;
-    load_serialised_asr(s, asr_binary, lm);
+    DecodedModfile m;
+    decode_serialised_asr(s.data(), s.size(), m);
+    add_file_locations(m, lm);
     uint32_t offset = 0;
-    ASR::asr_t *asr = deserialize_asr(al, asr_binary, load_symtab_id, offset);
+    ASR::asr_t *asr = deserialize_asr(al, m.asr_data, m.asr_size,
+        load_symtab_id, offset, false);
 
     ASR::TranslationUnit_t *tu = ASR::down_cast2<ASR::TranslationUnit_t>(asr);
     return tu;
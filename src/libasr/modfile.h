@@ -17,6 +17,55 @@ namespace LCompilers {
     ASR::TranslationUnit_t* load_pycfile(Allocator &al, const std::string &s,
         bool load_symtab_id, LCompilers::LocationManager &lm);
 
+    // Load a module from the modfile at `path`, returns nullptr if the file
+    // does not exist. The modfile is mapped into memory and cached for the
+    // whole process (until the file changes), so it is read from disk and
+    // its header decoded only once. Identifiers and constant arrays of the
+    // ASR point into it, so `al` keeps it mapped. The ASR itself is
+    // deserialized into `al` on every call, because the loaded modules are
+    // modified in place. If `lazy` is true, only the symbols of the module
+    // that are looked up are deserialized (see `deserialize_asr_lazy`).
+    ASR::TranslationUnit_t* load_modfile_from_path(Allocator &al,
+        const std::string &path, bool load_symtab_id, SymbolTable &symtab,
+        LCompilers::LocationManager &lm, bool lazy=false);
+
+    // Reads the hash of the module stored in the modfile at `path` (see
+    // `structural_hash()`), returns false if it is not a valid modfile
+    bool modfile_asr_hash(const std::string &path, uint64_t &hash);
+
+    // Writes the modfile `modfile` to `path`, replacing it atomically
+    bool write_modfile(const std::string &path, const std::string &modfile);
+
+    // Read the modfile at `path` into the process wide cache
+    bool preload_modfile(const std::string &path);
+
+    // A modfile linked into the executable (WITH_EMBEDDED_INTRINSIC_MODFILES)
+    struct EmbeddedModfile {
+        const char *name; // Module name, e.g. "lfortran_intrinsic_iso_c_binding"
+        const char *data;
+        size_t size;
+    };
+
+    // Registers `n` embedded modfiles, they must stay valid for the whole
+    // process. Called during static initialization by the generated source.
+    bool register_embedded_modfiles(const EmbeddedModfile *modfiles, size_t n);
+
+    // Load the module `name` from the embedded modfiles, returns nullptr if it
+    // is not embedded
+    ASR::TranslationUnit_t* load_embedded_modfile(Allocator &al,
+        const std::string &name, bool load_symtab_id,
+        LCompilers::LocationManager &lm, bool lazy=false);
+
+    // Lookups of modfiles in the process wide read cache. It caches the file
+    // contents only: the cached files are not read again, but every load
+    // still deserializes them
+    struct ModfileReadCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    ModfileReadCacheStats get_modfile_read_cache_stats();
+
 } // namespace LCompilers
 
 #endif // LFORTRAN_MODFILE_H
@@ -78,5 +78,16 @@ void pass_replace_do_loops(Allocator &al, ASR::TranslationUnit_t &unit,
     }
 }
 
+void pass_replace_do_loops_in_procedure(Allocator &al, ASR::symbol_t &procedure,
+                           const LCompilers::PassOptions& pass_options) {
+    DoLoopVisitor v(al, pass_options);
+    v.asr_changed = true;
+    v.use_loop_variable_after_loop = pass_options.use_loop_variable_after_loop;
+    while( v.asr_changed ) {
+        v.asr_changed = false;
+        v.visit_symbol(procedure);
+    }
+}
+
 
 } // namespace LCompilers
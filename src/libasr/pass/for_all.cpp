@@ -51,4 +51,10 @@ void pass_replace_for_all(Allocator &al, ASR::TranslationUnit_t &unit,
     v.visit_TranslationUnit(unit);
 }
 
+void pass_replace_for_all_in_procedure(Allocator &al, ASR::symbol_t &procedure,
+                         const LCompilers::PassOptions& /*pass_options*/) {
+    ForAllVisitor v(al);
+    v.visit_symbol(procedure);
+}
+
 } // namespace LCompilers
@@ -143,7 +143,7 @@ public:
         } else if (is_a<ASR::Var_t>(*arg)) {
             int arg_num = -1;
             int i = 0;
-            std::map<std::string, LCompilers::ASR::symbol_t *> func_scope = current_function->m_symtab->get_scope();
+            auto func_scope = current_function->m_symtab->get_scope();
             for (auto sym: func_scope) {
                 if (sym.second == ASR::down_cast<ASR::Var_t>(arg)->m_v) { 
                     arg_num = i;
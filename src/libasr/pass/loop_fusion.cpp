@@ -0,0 +1,932 @@
+#include <libasr/asr.h>
+#include <libasr/containers.h>
+#include <libasr/exception.h>
+#include <libasr/asr_utils.h>
+#include <libasr/asr_verify.h>
+#include <libasr/pass/loop_fusion.h>
+#include <libasr/pass/pass_utils.h>
+
+#include <map>
+#include <set>
+
+
+namespace LCompilers {
+
+using ASR::down_cast;
+using ASR::is_a;
+
+/*
+This ASR pass fuses adjacent DO loops with the same iteration space, e.g. the
+loops created by the `array_op` pass for
+
+    a = b + c
+    d = a * e
+
+become a single loop. Rank 1 temporary arrays that are only used inside of
+the fused loop, and in every iteration are written before they are read, are
+then replaced by scalars, so that `a` above is never stored.
+
+Loops are only fused if every array that one of them writes and the other
+one accesses is indexed by variables that have the same value in every
+iteration of both loops, so that each iteration of the fused loop reads
+exactly what the original loops read. The loops may only contain
+assignments and DO loops.
+
+Both loops must have the same number of iterations: their bounds have the
+same value, or each one runs over a whole dimension of an array and the two
+dimensions are declared with the same extent. If the loop variables differ,
+the variable of the second loop is incremented in the fused loop, so it ends
+with the same value as after the original loop.
+*/
+
+namespace {
+
+ASR::symbol_t* var_sym(ASR::expr_t *x) {
+    return down_cast<ASR::Var_t>(x)->m_v;
+}
+
+bool is_unit_step(ASR::expr_t *step) {
+    return step == nullptr || (is_a<ASR::IntegerConstant_t>(*step) &&
+        down_cast<ASR::IntegerConstant_t>(step)->m_n == 1);
+}
+
+// Whether `x` is a bound or the size of an array, or a constant: none of
+// them change inside of the loops this pass fuses
+bool is_invariant(ASR::expr_t *x) {
+    switch (x->type) {
+        case ASR::exprType::IntegerConstant: {
+            return true;
+        }
+        case ASR::exprType::IntegerBinOp: {
+            ASR::IntegerBinOp_t *op = down_cast<ASR::IntegerBinOp_t>(x);
+            return is_invariant(op->m_left) && is_invariant(op->m_right);
+        }
+        case ASR::exprType::ArrayBound: {
+            ASR::ArrayBound_t *b = down_cast<ASR::ArrayBound_t>(x);
+            return is_a<ASR::Var_t>(*b->m_v) && b->m_dim &&
+                is_a<ASR::IntegerConstant_t>(*b->m_dim);
+        }
+        case ASR::exprType::ArraySize: {
+            ASR::ArraySize_t *s = down_cast<ASR::ArraySize_t>(x);
+            return is_a<ASR::Var_t>(*s->m_v) && (!s->m_dim ||
+                is_a<ASR::IntegerConstant_t>(*s->m_dim));
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+// Recognizes `lbound(x, dim)` or `ubound(x, dim)` of an array variable `x`
+bool is_array_bound(ASR::expr_t *e, ASR::arrayboundType bound,
+        ASR::symbol_t *&x, int64_t &dim) {
+    if (!e || !is_a<ASR::ArrayBound_t>(*e)) return false;
+    ASR::ArrayBound_t *b = down_cast<ASR::ArrayBound_t>(e);
+    if (b->m_bound != bound || !is_a<ASR::Var_t>(*b->m_v)
+            || !b->m_dim || !is_a<ASR::IntegerConstant_t>(*b->m_dim)) {
+        return false;
+    }
+    x = var_sym(b->m_v);
+    dim = down_cast<ASR::IntegerConstant_t>(b->m_dim)->m_n;
+    return true;
+}
+
+// The value of `e` if it is known at compile time, including the bounds of
+// arrays with constant dimensions
+bool constant_value(ASR::expr_t *e, int64_t &value) {
+    if (is_a<ASR::IntegerConstant_t>(*e)) {
+        value = down_cast<ASR::IntegerConstant_t>(e)->m_n;
+        return true;
+    }
+    if (ASRUtils::is_value_constant(ASRUtils::expr_value(e), value)) {
+        return true;
+    }
+    ASR::symbol_t *x; int64_t dim;
+    bool lower = is_array_bound(e, ASR::arrayboundType::LBound, x, dim);
+    if (!lower && !is_array_bound(e, ASR::arrayboundType::UBound, x, dim)) {
+        return false;
+    }
+    ASR::ttype_t *type = ASRUtils::symbol_type(
+        ASRUtils::symbol_get_past_external(x));
+    ASR::dimension_t *m_dims = nullptr;
+    int n_dims = ASRUtils::extract_dimensions_from_ttype(type, m_dims);
+    if (ASRUtils::is_pointer(type) || dim < 1
+            || dim > n_dims || !m_dims[dim - 1].m_length) {
+        return false;
+    }
+    int64_t start = 1, length;
+    if (m_dims[dim - 1].m_start &&
+            !ASRUtils::is_value_constant(m_dims[dim - 1].m_start, start)) {
+        return false;
+    }
+    if (!ASRUtils::is_value_constant(m_dims[dim - 1].m_length, length)) {
+        return false;
+    }
+    value = lower ? start : start + length - 1;
+    return true;
+}
+
+bool same_value(ASR::expr_t *x, ASR::expr_t *y);
+
+// Whether the dimension `dim_x` of `x` and `dim_y` of `y` are declared with
+// the same extent. A length that is not constant is evaluated on entry of
+// the procedure, so it is only compared for arrays of the same scope.
+bool same_extent(ASR::symbol_t *x, int64_t dim_x, ASR::symbol_t *y,
+        int64_t dim_y) {
+    if (x == y && dim_x == dim_y) return true;
+    ASR::dimension_t *dims_x = nullptr, *dims_y = nullptr;
+    ASR::ttype_t *type_x = ASRUtils::symbol_type(
+        ASRUtils::symbol_get_past_external(x));
+    ASR::ttype_t *type_y = ASRUtils::symbol_type(
+        ASRUtils::symbol_get_past_external(y));
+    int n_x = ASRUtils::extract_dimensions_from_ttype(type_x, dims_x);
+    int n_y = ASRUtils::extract_dimensions_from_ttype(type_y, dims_y);
+    if (ASRUtils::is_pointer(type_x) || ASRUtils::is_pointer(type_y)
+            || dim_x < 1 || dim_x > n_x || dim_y < 1 || dim_y > n_y) {
+        return false;
+    }
+    ASR::expr_t *length_x = dims_x[dim_x - 1].m_length;
+    ASR::expr_t *length_y = dims_y[dim_y - 1].m_length;
+    if (!length_x || !length_y) return false;
+    int64_t cx, cy;
+    if (ASRUtils::is_value_constant(length_x, cx)
+            && ASRUtils::is_value_constant(length_y, cy)) {
+        return cx == cy;
+    }
+    return ASRUtils::symbol_parent_symtab(x) == ASRUtils::symbol_parent_symtab(y)
+        && same_value(length_x, length_y);
+}
+
+// Whether `x` and `y` always have the same value inside of the loops
+bool same_value(ASR::expr_t *x, ASR::expr_t *y) {
+    if (x == y) return true;
+    if (!x || !y) return false;
+    int64_t cx, cy;
+    if (constant_value(x, cx) && constant_value(y, cy)) {
+        return cx == cy;
+    }
+    if (x->type != y->type) return false;
+    switch (x->type) {
+        case ASR::exprType::Var: {
+            return var_sym(x) == var_sym(y);
+        }
+        case ASR::exprType::IntegerBinOp: {
+            ASR::IntegerBinOp_t *opx = down_cast<ASR::IntegerBinOp_t>(x);
+            ASR::IntegerBinOp_t *opy = down_cast<ASR::IntegerBinOp_t>(y);
+            return opx->m_op == opy->m_op &&
+                same_value(opx->m_left, opy->m_left) &&
+                same_value(opx->m_right, opy->m_right);
+        }
+        case ASR::exprType::ArrayBound: {
+            ASR::ArrayBound_t *bx = down_cast<ASR::ArrayBound_t>(x);
+            ASR::ArrayBound_t *by = down_cast<ASR::ArrayBound_t>(y);
+            return bx->m_bound == by->m_bound &&
+                same_value(bx->m_v, by->m_v) &&
+                same_value(bx->m_dim, by->m_dim);
+        }
+        case ASR::exprType::ArraySize: {
+            ASR::ArraySize_t *sx = down_cast<ASR::ArraySize_t>(x);
+            ASR::ArraySize_t *sy = down_cast<ASR::ArraySize_t>(y);
+            return same_value(sx->m_v, sy->m_v) &&
+                same_value(sx->m_dim, sy->m_dim);
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+// The variable `v` of `v = v + 1`
+ASR::symbol_t* incremented_var(ASR::stmt_t *x) {
+    if (!is_a<ASR::Assignment_t>(*x)) return nullptr;
+    ASR::Assignment_t *a = down_cast<ASR::Assignment_t>(x);
+    if (a->m_overloaded || !is_a<ASR::Var_t>(*a->m_target)
+            || !is_a<ASR::IntegerBinOp_t>(*a->m_value)
+            || !ASRUtils::is_integer(*ASRUtils::expr_type(a->m_target))) {
+        return nullptr;
+    }
+    ASR::IntegerBinOp_t *op = down_cast<ASR::IntegerBinOp_t>(a->m_value);
+    if (op->m_op != ASR::binopType::Add || !is_a<ASR::Var_t>(*op->m_left)
+            || var_sym(op->m_left) != var_sym(a->m_target)
+            || !op->m_right || !is_unit_step(op->m_right)) {
+        return nullptr;
+    }
+    return var_sym(a->m_target);
+}
+
+// Collects the variables that statements read and write. `ok` is cleared if
+// they contain anything whose effects are not tracked here.
+class LoopAccessCollector : public ASR::BaseWalkVisitor<LoopAccessCollector>
+{
+public:
+    bool ok = true;
+    std::set<ASR::symbol_t*> scalar_reads, scalar_writes;
+    std::set<ASR::symbol_t*> array_reads, array_writes;
+    // Arrays that are referenced as a whole, not element by element
+    std::set<ASR::symbol_t*> whole_arrays;
+    // Arrays whose bounds or size are used
+    std::set<ASR::symbol_t*> bound_arrays;
+    // Every array element access, and whether it is written
+    std::vector<std::pair<ASR::ArrayItem_t*, bool>> items;
+
+    void collect_stmt(ASR::stmt_t &x) {
+        if (is_a<ASR::Assignment_t>(x)) {
+            ASR::Assignment_t &a = *down_cast<ASR::Assignment_t>(&x);
+            if (a.m_overloaded) {
+                ok = false;
+                return;
+            }
+            visit_expr(*a.m_value);
+            if (is_a<ASR::Var_t>(*a.m_target) &&
+                    !ASRUtils::is_array(ASRUtils::expr_type(a.m_target))) {
+                scalar_writes.insert(var_sym(a.m_target));
+            } else if (is_a<ASR::ArrayItem_t>(*a.m_target)) {
+                collect_item(*down_cast<ASR::ArrayItem_t>(a.m_target), true);
+            } else {
+                ok = false;
+            }
+        } else if (is_a<ASR::DoLoop_t>(x)) {
+            ASR::DoLoop_t &loop = *down_cast<ASR::DoLoop_t>(&x);
+            if (loop.m_name || loop.n_orelse > 0
+                    || !is_a<ASR::Var_t>(*loop.m_head.m_v)) {
+                ok = false;
+                return;
+            }
+            scalar_writes.insert(var_sym(loop.m_head.m_v));
+            visit_expr(*loop.m_head.m_start);
+            visit_expr(*loop.m_head.m_end);
+            if (loop.m_head.m_increment) {
+                visit_expr(*loop.m_head.m_increment);
+            }
+            for (size_t i = 0; i < loop.n_body && ok; i++) {
+                collect_stmt(*loop.m_body[i]);
+            }
+        } else {
+            ok = false;
+        }
+    }
+
+    void collect_item(ASR::ArrayItem_t &x, bool is_write) {
+        if (!is_a<ASR::Var_t>(*x.m_v)
+                || ASRUtils::is_pointer(ASRUtils::expr_type(x.m_v))) {
+            ok = false;
+            return;
+        }
+        for (size_t i = 0; i < x.n_args; i++) {
+            if (x.m_args[i].m_left || x.m_args[i].m_step
+                    || !x.m_args[i].m_right) {
+                ok = false;
+                return;
+            }
+            visit_expr(*x.m_args[i].m_right);
+        }
+        ASR::symbol_t *v = var_sym(x.m_v);
+        if (is_write) {
+            array_writes.insert(v);
+        } else {
+            array_reads.insert(v);
+        }
+        items.push_back({&x, is_write});
+    }
+
+    void collect_bound(ASR::expr_t *v, ASR::expr_t *dim) {
+        if (is_a<ASR::Var_t>(*v)) {
+            bound_arrays.insert(var_sym(v));
+        } else {
+            visit_expr(*v);
+        }
+        if (dim) {
+            visit_expr(*dim);
+        }
+    }
+
+    void visit_Var(const ASR::Var_t &x) {
+        if (ASRUtils::is_array(ASRUtils::expr_type(&x.base))) {
+            whole_arrays.insert(x.m_v);
+        } else {
+            scalar_reads.insert(x.m_v);
+        }
+    }
+
+    void visit_ArrayItem(const ASR::ArrayItem_t &x) {
+        collect_item(const_cast<ASR::ArrayItem_t&>(x), false);
+    }
+
+    void visit_ArrayBound(const ASR::ArrayBound_t &x) {
+        collect_bound(x.m_v, x.m_dim);
+    }
+
+    void visit_ArraySize(const ASR::ArraySize_t &x) {
+        collect_bound(x.m_v, x.m_dim);
+    }
+
+    void visit_ArraySection(const ASR::ArraySection_t &/*x*/) {
+        ok = false;
+    }
+
+    // A procedure could access any variable of its host or of a module
+    void visit_FunctionCall(const ASR::FunctionCall_t &/*x*/) {
+        ok = false;
+    }
+
+    void visit_IntrinsicImpureFunction(
+            const ASR::IntrinsicImpureFunction_t &/*x*/) {
+        ok = false;
+    }
+};
+
+// Counts the references to a set of variables
+class VarCounter : public ASR::BaseWalkVisitor<VarCounter>
+{
+public:
+    std::map<ASR::symbol_t*, size_t> count;
+
+    void visit_Var(const ASR::Var_t &x) {
+        auto it = count.find(x.m_v);
+        if (it != count.end()) {
+            it->second++;
+        }
+    }
+};
+
+// Replaces the elements of an array by a scalar
+class ArrayItemReplacer : public ASR::BaseExprReplacer<ArrayItemReplacer>
+{
+public:
+    ASR::symbol_t *array;
+    ASR::expr_t *scalar;
+
+    ArrayItemReplacer(ASR::symbol_t *array_, ASR::expr_t *scalar_) :
+        array(array_), scalar(scalar_) {}
+
+    void replace_ArrayItem(ASR::ArrayItem_t *x) {
+        if (is_a<ASR::Var_t>(*x->m_v) && var_sym(x->m_v) == array) {
+            *current_expr = scalar;
+            return;
+        }
+        ASR::BaseExprReplacer<ArrayItemReplacer>::replace_ArrayItem(x);
+    }
+};
+
+// A DO loop and the variables that advance by one in every iteration of it
+struct LoopInfo {
+    ASR::DoLoop_t *loop = nullptr;
+    // Number of statements at the end of the body that increment a variable
+    // by one (`j = j + 1`)
+    size_t n_increments = 0;
+    // The variables that advance by one in every iteration (starting with
+    // the loop variable) and their value in the first iteration, nullptr if
+    // it is not known
+    std::vector<std::pair<ASR::symbol_t*, ASR::expr_t*>> level_vars;
+    LoopAccessCollector accesses;
+
+    bool is_level_var(ASR::symbol_t *v) const {
+        for (auto &l : level_vars) {
+            if (l.first == v) return true;
+        }
+        return false;
+    }
+
+    ASR::expr_t* level_init(ASR::symbol_t *v) const {
+        for (auto &l : level_vars) {
+            if (l.first == v) return l.second;
+        }
+        return nullptr;
+    }
+};
+
+} // namespace
+
+class LoopFusionVisitor : public ASR::ASRPassBaseWalkVisitor<LoopFusionVisitor>
+{
+private:
+
+    Allocator &al;
+
+public:
+
+    LoopFusionVisitor(Allocator &al_) : al(al_) { }
+
+    // The assignments of loop invariant values to scalars right before
+    // `body[pos]`, the closest one for every variable
+    std::map<ASR::symbol_t*, ASR::Assignment_t*> collect_inits(
+            std::vector<ASR::stmt_t*> &body, size_t pos) {
+        std::map<ASR::symbol_t*, ASR::Assignment_t*> inits;
+        while (pos > 0 && is_invariant_init(body[pos - 1])) {
+            ASR::Assignment_t *a = down_cast<ASR::Assignment_t>(body[pos - 1]);
+            inits.insert({var_sym(a->m_target), a});
+            pos--;
+        }
+        return inits;
+    }
+
+    bool is_invariant_init(ASR::stmt_t *x) {
+        if (!is_a<ASR::Assignment_t>(*x)) return false;
+        ASR::Assignment_t *a = down_cast<ASR::Assignment_t>(x);
+        return !a->m_overloaded && is_a<ASR::Var_t>(*a->m_target) &&
+            ASRUtils::is_integer(*ASRUtils::expr_type(a->m_target)) &&
+            is_invariant(a->m_value);
+    }
+
+    bool analyze_loop(ASR::DoLoop_t *loop,
+            const std::map<ASR::symbol_t*, ASR::Assignment_t*> &inits,
+            LoopInfo &info) {
+        if (loop->m_name || loop->n_orelse > 0
+                || !is_a<ASR::Var_t>(*loop->m_head.m_v)) {
+            return false;
+        }
+        info.loop = loop;
+        ASR::symbol_t *loop_var = var_sym(loop->m_head.m_v);
+        std::vector<ASR::symbol_t*> incremented;
+        while (info.n_increments < loop->n_body) {
+            ASR::symbol_t *v = incremented_var(
+                loop->m_body[loop->n_body - 1 - info.n_increments]);
+            if (!v || v == loop_var || std::find(incremented.begin(),
+                    incremented.end(), v) != incremented.end()) {
+                break;
+            }
+            incremented.push_back(v);
+            info.n_increments++;
+        }
+        LoopAccessCollector &accesses = info.accesses;
+        for (size_t i = 0; i < loop->n_body - info.n_increments; i++) {
+            accesses.collect_stmt(*loop->m_body[i]);
+        }
+        accesses.visit_expr(*loop->m_head.m_start);
+        accesses.visit_expr(*loop->m_head.m_end);
+        if (loop->m_head.m_increment) {
+            accesses.visit_expr(*loop->m_head.m_increment);
+        }
+        if (!accesses.ok || accesses.scalar_writes.count(loop_var)) {
+            return false;
+        }
+        if (is_unit_step(loop->m_head.m_increment)) {
+            info.level_vars.push_back({loop_var, loop->m_head.m_start});
+        }
+        // The incremented variables are only known to advance with the loop
+        // if nothing else writes them
+        for (size_t i = incremented.size(); i > 0; i--) {
+            ASR::symbol_t *v = incremented[i - 1];
+            if (accesses.scalar_writes.count(v)) continue;
+            auto it = inits.find(v);
+            info.level_vars.push_back({v,
+                it != inits.end() ? it->second->m_value : nullptr});
+        }
+        for (size_t i = loop->n_body - info.n_increments; i < loop->n_body; i++) {
+            accesses.collect_stmt(*loop->m_body[i]);
+        }
+        accesses.scalar_writes.insert(loop_var);
+        return true;
+    }
+
+    // Whether the loop runs from `lbound(x, dim)` to `ubound(x, dim)`
+    bool head_covers(const ASR::do_loop_head_t &head, ASR::symbol_t *&x,
+            int64_t &dim) {
+        ASR::symbol_t *y; int64_t dim_y;
+        return is_unit_step(head.m_increment)
+            && is_array_bound(head.m_start, ASR::arrayboundType::LBound, x, dim)
+            && is_array_bound(head.m_end, ASR::arrayboundType::UBound, y, dim_y)
+            && x == y && dim == dim_y;
+    }
+
+    // Whether every access of `x` in both loops refers to the same element in
+    // the same iteration
+    bool is_aligned(ASR::symbol_t *x, const LoopInfo &l1, const LoopInfo &l2) {
+        size_t rank = ASRUtils::extract_n_dims_from_ttype(ASRUtils::symbol_type(x));
+        for (size_t d = 0; d < rank; d++) {
+            ASR::expr_t *init = nullptr;
+            bool aligned = true;
+            for (const LoopInfo *info : {&l1, &l2}) {
+                for (auto &item : info->accesses.items) {
+                    if (var_sym(item.first->m_v) != x) continue;
+                    if (d >= item.first->n_args) return false;
+                    ASR::expr_t *sub = item.first->m_args[d].m_right;
+                    ASR::expr_t *sub_init = is_a<ASR::Var_t>(*sub) ?
+                        info->level_init(var_sym(sub)) : nullptr;
+                    if (!sub_init || (init && !same_value(init, sub_init))) {
+                        aligned = false;
+                        break;
+                    }
+                    init = sub_init;
+                }
+                if (!aligned) break;
+            }
+            if (aligned) return true;
+        }
+        return false;
+    }
+
+    ASR::stmt_t* make_increment(ASR::expr_t *v) {
+        const Location &loc = v->base.loc;
+        ASR::ttype_t *type = ASRUtils::expr_type(v);
+        ASR::expr_t *one = ASRUtils::EXPR(ASR::make_IntegerConstant_t(
+            al, loc, 1, type));
+        return ASRUtils::STMT(ASR::make_Assignment_t(al, loc, v,
+            ASRUtils::EXPR(ASR::make_IntegerBinOp_t(al, loc, v,
+                ASR::binopType::Add, one, type, nullptr)), nullptr));
+    }
+
+    // Fuses the loop `body[p]` with the next loop in `body` if possible. The
+    // statements between them are moved before the fused loop, `p` is
+    // updated to its new position.
+    bool try_fuse(std::vector<ASR::stmt_t*> &body, size_t &p) {
+        size_t q = p + 1;
+        while (q < body.size() && is_invariant_init(body[q])) q++;
+        if (q >= body.size() || !is_a<ASR::DoLoop_t>(*body[q])) return false;
+        ASR::DoLoop_t *loop1 = down_cast<ASR::DoLoop_t>(body[p]);
+        ASR::DoLoop_t *loop2 = down_cast<ASR::DoLoop_t>(body[q]);
+        LoopInfo l1, l2;
+        if (!analyze_loop(loop1, collect_inits(body, p), l1)
+                || !analyze_loop(loop2, collect_inits(body, q), l2)) {
+            return false;
+        }
+        LoopAccessCollector &a1 = l1.accesses, &a2 = l2.accesses;
+
+        // Both loops must have the same number of iterations
+        ASR::symbol_t *v1 = var_sym(loop1->m_head.m_v);
+        ASR::symbol_t *v2 = var_sym(loop2->m_head.m_v);
+        const ASR::do_loop_head_t &h1 = loop1->m_head, &h2 = loop2->m_head;
+        bool same_head = same_value(h1.m_start, h2.m_start)
+            && same_value(h1.m_end, h2.m_end)
+            && (is_unit_step(h1.m_increment) ? is_unit_step(h2.m_increment)
+                : same_value(h1.m_increment, h2.m_increment));
+        if (!same_head) {
+            if (v1 == v2 || !is_unit_step(h1.m_increment)
+                    || !is_unit_step(h2.m_increment)) {
+                return false;
+            }
+            ASR::symbol_t *x1, *x2; int64_t dim1, dim2;
+            if (!head_covers(h1, x1, dim1) || !head_covers(h2, x2, dim2)
+                    || !same_extent(x1, dim1, x2, dim2)) {
+                return false;
+            }
+        }
+        // The loop variable of the second loop becomes a variable that is
+        // incremented in the fused loop
+        if (v1 != v2 && (!is_unit_step(h2.m_increment)
+                || !is_invariant(h2.m_start)
+                || a1.scalar_reads.count(v2) || a1.scalar_writes.count(v2))) {
+            return false;
+        }
+
+        // The statements in between are moved before the first loop
+        for (size_t i = p + 1; i < q; i++) {
+            ASR::symbol_t *v = var_sym(
+                down_cast<ASR::Assignment_t>(body[i])->m_target);
+            if (a1.scalar_reads.count(v) || a1.scalar_writes.count(v)) {
+                return false;
+            }
+        }
+
+        for (ASR::symbol_t *v : a1.scalar_writes) {
+            if (v == v1 && v1 == v2) continue;
+            if (a2.scalar_reads.count(v) || a2.scalar_writes.count(v)) {
+                return false;
+            }
+        }
+        for (ASR::symbol_t *v : a2.scalar_writes) {
+            if (v == v2 && v1 == v2) continue;
+            if (a1.scalar_reads.count(v)) return false;
+        }
+
+        std::set<ASR::symbol_t*> conflicts;
+        for (ASR::symbol_t *v : a1.array_writes) {
+            if (a2.array_reads.count(v) || a2.array_writes.count(v)
+                    || a2.whole_arrays.count(v)) {
+                conflicts.insert(v);
+            }
+        }
+        for (ASR::symbol_t *v : a2.array_writes) {
+            if (a1.array_reads.count(v) || a1.whole_arrays.count(v)) {
+                conflicts.insert(v);
+            }
+        }
+        for (ASR::symbol_t *v : conflicts) {
+            if (a1.whole_arrays.count(v) || a2.whole_arrays.count(v)
+                    || !is_aligned(v, l1, l2)) {
+                return false;
+            }
+        }
+
+        Vec<ASR::stmt_t*> fused_body;
+        fused_body.reserve(al, loop1->n_body + loop2->n_body + 1);
+        for (size_t i = 0; i < loop1->n_body - l1.n_increments; i++) {
+            fused_body.push_back(al, loop1->m_body[i]);
+        }
+        for (size_t i = 0; i < loop2->n_body - l2.n_increments; i++) {
+            fused_body.push_back(al, loop2->m_body[i]);
+        }
+        for (size_t i = loop1->n_body - l1.n_increments; i < loop1->n_body; i++) {
+            fused_body.push_back(al, loop1->m_body[i]);
+        }
+        for (size_t i = loop2->n_body - l2.n_increments; i < loop2->n_body; i++) {
+            fused_body.push_back(al, loop2->m_body[i]);
+        }
+        std::vector<ASR::stmt_t*> moved(body.begin() + p + 1, body.begin() + q);
+        if (v1 != v2) {
+            fused_body.push_back(al, make_increment(h2.m_v));
+            moved.push_back(ASRUtils::STMT(ASR::make_Assignment_t(al,
+                h2.loc, h2.m_v, h2.m_start, nullptr)));
+        }
+        loop1->m_body = fused_body.p;
+        loop1->n_body = fused_body.size();
+        body.erase(body.begin() + p + 1, body.begin() + q + 1);
+        body.insert(body.begin() + p, moved.begin(), moved.end());
+        p += moved.size();
+        return true;
+    }
+
+    // Replaces the rank 1 array `x` by a scalar if it is only used inside of
+    // the loop `body[p]`, and in every iteration written before it is read
+    bool contract(std::vector<ASR::stmt_t*> &body, size_t &p,
+            const LoopInfo &info, ASR::symbol_t *x) {
+        if (!is_a<ASR::Variable_t>(*x)) return false;
+        ASR::Variable_t *var = down_cast<ASR::Variable_t>(x);
+        if (var->m_parent_symtab != current_scope
+                || !current_scope->asr_owner
+                || !is_a<ASR::symbol_t>(*current_scope->asr_owner)
+                || var->m_intent != ASR::intentType::Local
+                || var->m_storage != ASR::storage_typeType::Default
+                || var->m_symbolic_value || var->m_value || var->m_target_attr
+                || ASRUtils::is_pointer(var->m_type)
+                || ASRUtils::extract_n_dims_from_ttype(var->m_type) != 1
+                || info.accesses.whole_arrays.count(x)) {
+            return false;
+        }
+        ASR::ttype_t *elem_type = ASRUtils::extract_type(var->m_type);
+        if (!is_a<ASR::Integer_t>(*elem_type) && !is_a<ASR::Real_t>(*elem_type)
+                && !is_a<ASR::Complex_t>(*elem_type)
+                && !is_a<ASR::Logical_t>(*elem_type)) {
+            return false;
+        }
+
+        ASR::DoLoop_t *loop = info.loop;
+        size_t n_stmts = loop->n_body - info.n_increments;
+        bool written = false;
+        for (size_t i = 0; i < n_stmts; i++) {
+            LoopAccessCollector stmt_accesses;
+            if (is_a<ASR::DoLoop_t>(*loop->m_body[i])) {
+                stmt_accesses.collect_stmt(*loop->m_body[i]);
+                if (stmt_accesses.array_reads.count(x)
+                        || stmt_accesses.array_writes.count(x)
+                        || stmt_accesses.bound_arrays.count(x)) {
+                    return false;
+                }
+                continue;
+            }
+            ASR::Assignment_t *a = down_cast<ASR::Assignment_t>(loop->m_body[i]);
+            stmt_accesses.visit_expr(*a->m_value);
+            bool writes_x = false;
+            if (is_a<ASR::ArrayItem_t>(*a->m_target)) {
+                ASR::ArrayItem_t *target = down_cast<ASR::ArrayItem_t>(a->m_target);
+                for (size_t j = 0; j < target->n_args; j++) {
+                    stmt_accesses.visit_expr(*target->m_args[j].m_right);
+                }
+                writes_x = var_sym(target->m_v) == x;
+            }
+            if ((stmt_accesses.array_reads.count(x) && !written)
+                    || stmt_accesses.bound_arrays.count(x)) {
+                return false;
+            }
+            written = written || writes_x;
+        }
+
+        // The subscripts of `x`: variables with the same value in an iteration
+        ASR::expr_t *init = nullptr;
+        std::vector<ASR::symbol_t*> index_vars;
+        std::map<ASR::symbol_t*, size_t> index_uses;
+        size_t n_items = 0;
+        for (auto &item : info.accesses.items) {
+            if (var_sym(item.first->m_v) != x) continue;
+            ASR::expr_t *sub = item.first->m_args[0].m_right;
+            if (!is_a<ASR::Var_t>(*sub)) return false;
+            ASR::symbol_t *s = var_sym(sub);
+            ASR::expr_t *s_init = info.level_init(s);
+            if (!s_init || (init && !same_value(init, s_init))) return false;
+            init = s_init;
+            if (index_uses[s]++ == 0) index_vars.push_back(s);
+            n_items++;
+        }
+
+        // If the loop traverses `x`, it has to traverse a dimension of another
+        // array with the same extent instead
+        const ASR::do_loop_head_t &head = loop->m_head;
+        ASR::symbol_t *loop_var = var_sym(head.m_v);
+        LoopAccessCollector head_accesses;
+        head_accesses.visit_expr(*head.m_start);
+        head_accesses.visit_expr(*head.m_end);
+        if (head.m_increment) head_accesses.visit_expr(*head.m_increment);
+        bool head_uses_x = head_accesses.bound_arrays.count(x) > 0;
+        ASR::symbol_t *y = nullptr; int64_t dim_y = 0;
+        if (head_uses_x) {
+            ASR::symbol_t *h; int64_t dim;
+            if (!head_covers(head, h, dim) || h != x) return false;
+            for (size_t i = 0; i < info.accesses.items.size() && !y; i++) {
+                ASR::ArrayItem_t *item = info.accesses.items[i].first;
+                ASR::symbol_t *z = var_sym(item->m_v);
+                for (size_t d = 1; d <= item->n_args && z != x; d++) {
+                    if (same_extent(x, dim, z, d)) {
+                        y = z;
+                        dim_y = d;
+                        break;
+                    }
+                }
+            }
+            if (!y) return false;
+        }
+
+        std::map<ASR::symbol_t*, ASR::Assignment_t*> inits = collect_inits(body, p);
+        VarCounter counter;
+        counter.count[x] = 0;
+        size_t expected_x = n_items + (head_uses_x ? 2 : 0);
+        std::map<ASR::symbol_t*, size_t> expected;
+        for (ASR::symbol_t *s : index_vars) {
+            if (s == loop_var) {
+                if (!head_uses_x) continue;
+                expected[s] = index_uses[s] + 1;
+            } else {
+                auto it = inits.find(s);
+                if (it == inits.end() || !is_a<ASR::Variable_t>(*s)
+                        || ASRUtils::symbol_parent_symtab(s) != current_scope) {
+                    return false;
+                }
+                VarCounter init_counter;
+                init_counter.count[x] = 0;
+                init_counter.visit_expr(*it->second->m_value);
+                expected_x += init_counter.count[x];
+                // The initialization and the increment
+                expected[s] = index_uses[s] + 3;
+            }
+            counter.count[s] = 0;
+        }
+        std::set<ASR::stmt_t*> removed;
+        for (ASR::stmt_t *s : body) {
+            if (allocates_only(s, x)) {
+                VarCounter stmt_counter;
+                stmt_counter.count[x] = 0;
+                stmt_counter.visit_stmt(*s);
+                expected_x += stmt_counter.count[x];
+                removed.insert(s);
+            }
+        }
+        counter.visit_symbol(*down_cast<ASR::symbol_t>(current_scope->asr_owner));
+        if (counter.count[x] != expected_x) return false;
+        for (auto &e : expected) {
+            if (counter.count[e.first] != e.second) return false;
+        }
+
+        const Location &loc = var->base.base.loc;
+        std::string name = current_scope->get_unique_name(
+            "__libasr_fused_" + std::string(var->m_name));
+        ASR::symbol_t *scalar = down_cast<ASR::symbol_t>(
+            ASRUtils::make_Variable_t_util(al, loc, current_scope,
+                s2c(al, name), nullptr, 0, ASR::intentType::Local, nullptr,
+                nullptr, ASR::storage_typeType::Default, elem_type, nullptr,
+                ASR::abiType::Source, ASR::accessType::Public,
+                ASR::presenceType::Required, false));
+        current_scope->add_symbol(name, scalar);
+        ArrayItemReplacer replacer(x,
+            ASRUtils::EXPR(ASR::make_Var_t(al, loc, scalar)));
+        for (size_t i = 0; i < n_stmts; i++) {
+            if (!is_a<ASR::Assignment_t>(*loop->m_body[i])) continue;
+            ASR::Assignment_t *a = down_cast<ASR::Assignment_t>(loop->m_body[i]);
+            replacer.current_expr = &a->m_target;
+            replacer.replace_expr(a->m_target);
+            replacer.current_expr = &a->m_value;
+            replacer.replace_expr(a->m_value);
+        }
+        if (head_uses_x) {
+            ASR::expr_t *y_expr = ASRUtils::EXPR(ASR::make_Var_t(al, loc, y));
+            loop->m_head.m_start = PassUtils::get_bound(y_expr, dim_y, "lbound", al);
+            loop->m_head.m_end = PassUtils::get_bound(y_expr, dim_y, "ubound", al);
+        }
+
+        // Remove the index variables that only pointed into `x`
+        Vec<ASR::stmt_t*> loop_body;
+        loop_body.reserve(al, loop->n_body);
+        for (size_t i = 0; i < loop->n_body; i++) {
+            ASR::symbol_t *v = i < n_stmts ? nullptr : incremented_var(loop->m_body[i]);
+            if (v && v != loop_var && expected.count(v)) continue;
+            loop_body.push_back(al, loop->m_body[i]);
+        }
+        loop->m_body = loop_body.p;
+        loop->n_body = loop_body.size();
+        for (auto &e : expected) {
+            if (e.first != loop_var) removed.insert(&inits[e.first]->base);
+        }
+        ASR::stmt_t *loop_stmt = body[p];
+        std::vector<ASR::stmt_t*> new_body;
+        for (ASR::stmt_t *s : body) {
+            if (removed.count(s)) continue;
+            if (s == loop_stmt) p = new_body.size();
+            new_body.push_back(s);
+        }
+        body = new_body;
+        for (auto &e : expected) {
+            if (e.first != loop_var) {
+                current_scope->erase_symbol(ASRUtils::symbol_name(e.first));
+            }
+        }
+        current_scope->erase_symbol(var->m_name);
+        return true;
+    }
+
+    // Whether `x` allocates or deallocates only the array `v`
+    bool allocates_only(ASR::stmt_t *x, ASR::symbol_t *v) {
+        auto is_v = [&](ASR::expr_t *e) {
+            return e && is_a<ASR::Var_t>(*e) && var_sym(e) == v;
+        };
+        switch (x->type) {
+            case ASR::stmtType::Allocate: {
+                ASR::Allocate_t *a = down_cast<ASR::Allocate_t>(x);
+                return a->n_args == 1 && is_v(a->m_args[0].m_a) &&
+                    !a->m_stat && !a->m_errmsg && !a->m_source;
+            }
+            case ASR::stmtType::ReAlloc: {
+                ASR::ReAlloc_t *a = down_cast<ASR::ReAlloc_t>(x);
+                return a->n_args == 1 && is_v(a->m_args[0].m_a);
+            }
+            case ASR::stmtType::ExplicitDeallocate: {
+                ASR::ExplicitDeallocate_t *d = down_cast<ASR::ExplicitDeallocate_t>(x);
+                return d->n_vars == 1 && is_v(d->m_vars[0]);
+            }
+            case ASR::stmtType::ImplicitDeallocate: {
+                ASR::ImplicitDeallocate_t *d = down_cast<ASR::ImplicitDeallocate_t>(x);
+                return d->n_vars == 1 && is_v(d->m_vars[0]);
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+
+    // Replaces the temporaries of the fused loop `body[p]` by scalars
+    void contract_temporaries(std::vector<ASR::stmt_t*> &body, size_t &p) {
+        bool contracted = true;
+        while (contracted) {
+            contracted = false;
+            LoopInfo info;
+            if (!analyze_loop(down_cast<ASR::DoLoop_t>(body[p]),
+                    collect_inits(body, p), info)) {
+                return;
+            }
+            std::vector<ASR::symbol_t*> candidates;
+            for (auto &item : info.accesses.items) {
+                ASR::symbol_t *x = var_sym(item.first->m_v);
+                if (item.second && std::find(candidates.begin(),
+                        candidates.end(), x) == candidates.end()) {
+                    candidates.push_back(x);
+                }
+            }
+            for (ASR::symbol_t *x : candidates) {
+                if (contract(body, p, info, x)) {
+                    contracted = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    void store(const std::vector<ASR::stmt_t*> &body,
+            ASR::stmt_t **&m_body, size_t &n_body) {
+        Vec<ASR::stmt_t*> new_body;
+        new_body.reserve(al, body.size());
+        for (ASR::stmt_t *s : body) {
+            new_body.push_back(al, s);
+        }
+        m_body = new_body.p;
+        n_body = new_body.size();
+    }
+
+    void fuse_stmts(ASR::stmt_t **&m_body, size_t &n_body) {
+        std::vector<ASR::stmt_t*> body(m_body, m_body + n_body);
+        for (size_t p = 0; p < body.size(); p++) {
+            if (!is_a<ASR::DoLoop_t>(*body[p])) continue;
+            bool fused = false;
+            while (try_fuse(body, p)) fused = true;
+            if (!fused) continue;
+            // The fused bodies may contain loops that can be fused in turn
+            store(body, m_body, n_body);
+            ASR::DoLoop_t *loop = down_cast<ASR::DoLoop_t>(body[p]);
+            fuse_stmts(loop->m_body, loop->n_body);
+            contract_temporaries(body, p);
+            store(body, m_body, n_body);
+        }
+    }
+
+    void transform_stmts(ASR::stmt_t **&m_body, size_t &n_body) {
+        for (size_t i = 0; i < n_body; i++) {
+            visit_stmt(*m_body[i]);
+        }
+        fuse_stmts(m_body, n_body);
+    }
+};
+
+void pass_loop_fusion(Allocator &al, ASR::TranslationUnit_t &unit,
+                      const PassOptions &/*pass_options*/) {
+    LoopFusionVisitor v(al);
+    v.visit_TranslationUnit(unit);
+}
+
+
+} // namespace LCompilers
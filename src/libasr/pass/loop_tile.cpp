@@ -0,0 +1,464 @@
+#include <libasr/asr.h>
+#include <libasr/containers.h>
+#include <libasr/exception.h>
+#include <libasr/asr_utils.h>
+#include <libasr/asr_verify.h>
+#include <libasr/pass/loop_tile.h>
+#include <libasr/pass/pass_utils.h>
+
+#include <cmath>
+#include <map>
+#include <set>
+
+
+namespace LCompilers {
+
+using ASR::down_cast;
+using ASR::is_a;
+
+/*
+This ASR pass improves the cache locality of perfectly nested DO loops whose
+body only assigns array elements, such as
+
+    do i = 1, n
+        do j = 1, n
+            do k = 1, n
+                c(i,j) = c(i,j) + a(i,k) * b(k,j)
+            end do
+        end do
+    end do
+
+First the loops are interchanged, so that the innermost loop walks the first
+(contiguous) dimension of the most arrays. Then, if array elements are reused
+across the iterations of outer loops, every loop is tiled: the
+nest is split into loops over tiles of `tile` iterations and loops over the
+iterations of a tile,
+
+    do j_tile = 1, n, tile
+        ...
+        do j = j_tile, min(j_tile + tile - 1, n)
+            ...
+
+The tile size is chosen such that a tile of every array accessed in the nest
+fits into `PassOptions::tile_cache_size` bytes. The tile loops keep the
+original bounds, so a nest with a zero-trip loop executes no iterations
+before and after tiling. The bounds are evaluated again for every tile, which
+is only valid because they call no procedures and read nothing the nest
+writes (checked below).
+
+Both transformations reorder the iterations, so the nest has to be fully
+permutable. This is checked conservatively:
+
+* The bounds of the loops do not depend on each other and the nest writes no
+  scalars.
+* Every access of an array that the nest writes uses the same subscripts.
+  Each subscript is an invariant or a different loop variable (plus an
+  invariant), and at most one loop variable does not appear in them (as `k`
+  above). Hence an element is only accessed by the iterations of that one
+  loop, whose order does not change.
+*/
+
+namespace {
+
+ASR::symbol_t* var_sym(ASR::expr_t *x) {
+    return down_cast<ASR::Var_t>(x)->m_v;
+}
+
+bool is_unit_step(ASR::expr_t *step) {
+    return step == nullptr || (is_a<ASR::IntegerConstant_t>(*step) &&
+        down_cast<ASR::IntegerConstant_t>(step)->m_n == 1);
+}
+
+bool constant_int(ASR::expr_t *x, int64_t &value) {
+    if (is_a<ASR::IntegerConstant_t>(*x)) {
+        value = down_cast<ASR::IntegerConstant_t>(x)->m_n;
+        return true;
+    }
+    return ASRUtils::is_value_constant(ASRUtils::expr_value(x), value);
+}
+
+// Whether `x` and `y` are the same subscript expression
+bool same_subscript(ASR::expr_t *x, ASR::expr_t *y) {
+    if (x->type != y->type) return false;
+    switch (x->type) {
+        case ASR::exprType::Var: {
+            return var_sym(x) == var_sym(y);
+        }
+        case ASR::exprType::IntegerConstant: {
+            return down_cast<ASR::IntegerConstant_t>(x)->m_n ==
+                down_cast<ASR::IntegerConstant_t>(y)->m_n;
+        }
+        case ASR::exprType::IntegerBinOp: {
+            ASR::IntegerBinOp_t *opx = down_cast<ASR::IntegerBinOp_t>(x);
+            ASR::IntegerBinOp_t *opy = down_cast<ASR::IntegerBinOp_t>(y);
+            return opx->m_op == opy->m_op &&
+                same_subscript(opx->m_left, opy->m_left) &&
+                same_subscript(opx->m_right, opy->m_right);
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+// Collects the array elements and scalars that statements access. `ok` is
+// cleared if they contain anything whose effects are not tracked here.
+class NestAccessCollector : public ASR::BaseWalkVisitor<NestAccessCollector>
+{
+public:
+    bool ok = true;
+    std::set<ASR::symbol_t*> scalar_reads;
+    // Arrays that are referenced as a whole, not element by element
+    std::set<ASR::symbol_t*> whole_arrays;
+    // Every array element access, and whether it is written
+    std::vector<std::pair<ASR::ArrayItem_t*, bool>> items;
+
+    void collect_assignment(ASR::Assignment_t &a) {
+        if (a.m_overloaded || !is_a<ASR::ArrayItem_t>(*a.m_target)) {
+            ok = false;
+            return;
+        }
+        visit_expr(*a.m_value);
+        collect_item(*down_cast<ASR::ArrayItem_t>(a.m_target), true);
+    }
+
+    void collect_item(ASR::ArrayItem_t &x, bool is_write) {
+        if (!is_a<ASR::Var_t>(*x.m_v)
+                || ASRUtils::is_pointer(ASRUtils::expr_type(x.m_v))) {
+            ok = false;
+            return;
+        }
+        for (size_t i = 0; i < x.n_args; i++) {
+            if (x.m_args[i].m_left || x.m_args[i].m_step
+                    || !x.m_args[i].m_right) {
+                ok = false;
+                return;
+            }
+            visit_expr(*x.m_args[i].m_right);
+        }
+        items.push_back({&x, is_write});
+    }
+
+    void visit_Var(const ASR::Var_t &x) {
+        if (ASRUtils::is_array(ASRUtils::expr_type(&x.base))) {
+            whole_arrays.insert(x.m_v);
+        } else {
+            scalar_reads.insert(x.m_v);
+        }
+    }
+
+    void visit_ArrayItem(const ASR::ArrayItem_t &x) {
+        collect_item(const_cast<ASR::ArrayItem_t&>(x), false);
+    }
+
+    void visit_ArraySection(const ASR::ArraySection_t &/*x*/) {
+        ok = false;
+    }
+
+    // A procedure could access any variable of its host or of a module
+    void visit_FunctionCall(const ASR::FunctionCall_t &/*x*/) {
+        ok = false;
+    }
+
+    void visit_IntrinsicImpureFunction(
+            const ASR::IntrinsicImpureFunction_t &/*x*/) {
+        ok = false;
+    }
+};
+
+} // namespace
+
+class LoopTileVisitor : public ASR::ASRPassBaseWalkVisitor<LoopTileVisitor>
+{
+private:
+
+    Allocator &al;
+    int64_t cache_size;
+
+    std::vector<ASR::DoLoop_t*> nest;
+    std::vector<ASR::symbol_t*> loop_vars;
+
+public:
+
+    LoopTileVisitor(Allocator &al_, int64_t cache_size_) :
+        al(al_), cache_size(cache_size_) { }
+
+    // The loop variable `v` if `x` is `v`, `v + c`, `c + v` or `v - c`,
+    // nullptr if `x` does not use any loop variable. Sets `ok` to false
+    // otherwise.
+    ASR::symbol_t* subscript_var(ASR::expr_t *x, bool &ok) {
+        NestAccessCollector c;
+        c.visit_expr(*x);
+        std::vector<ASR::symbol_t*> used;
+        for (ASR::symbol_t *v : loop_vars) {
+            if (c.scalar_reads.count(v)) used.push_back(v);
+        }
+        if (used.empty()) {
+            ok = ok && c.ok && c.items.empty();
+            return nullptr;
+        }
+        ASR::symbol_t *v = used[0];
+        if (used.size() == 1 && c.items.empty()) {
+            if (is_a<ASR::Var_t>(*x)) return v;
+            if (is_a<ASR::IntegerBinOp_t>(*x)) {
+                ASR::IntegerBinOp_t *op = down_cast<ASR::IntegerBinOp_t>(x);
+                auto is_v = [&](ASR::expr_t *e) {
+                    return is_a<ASR::Var_t>(*e) && var_sym(e) == v;
+                };
+                ASR::expr_t *c = nullptr;
+                if ((op->m_op == ASR::binopType::Add
+                        || op->m_op == ASR::binopType::Sub) && is_v(op->m_left)) {
+                    c = op->m_right;
+                } else if (op->m_op == ASR::binopType::Add && is_v(op->m_right)) {
+                    c = op->m_left;
+                }
+                bool c_ok = true;
+                if (c && !subscript_var(c, c_ok) && c_ok) {
+                    return v;
+                }
+            }
+        }
+        ok = false;
+        return nullptr;
+    }
+
+    // Whether the iterations of the nest can be executed in any order of the
+    // loops, see the comment at the top
+    bool is_permutable(const NestAccessCollector &accesses) {
+        std::set<ASR::symbol_t*> written;
+        for (auto &item : accesses.items) {
+            if (item.second) written.insert(var_sym(item.first->m_v));
+        }
+        for (ASR::symbol_t *x : written) {
+            if (accesses.whole_arrays.count(x)) return false;
+            ASR::ArrayItem_t *first = nullptr;
+            for (auto &item : accesses.items) {
+                if (var_sym(item.first->m_v) != x) continue;
+                if (!first) {
+                    first = item.first;
+                    continue;
+                }
+                if (item.first->n_args != first->n_args) return false;
+                for (size_t d = 0; d < first->n_args; d++) {
+                    if (!same_subscript(item.first->m_args[d].m_right,
+                            first->m_args[d].m_right)) {
+                        return false;
+                    }
+                }
+            }
+            std::set<ASR::symbol_t*> used;
+            for (size_t d = 0; d < first->n_args; d++) {
+                bool ok = true;
+                ASR::symbol_t *v = subscript_var(first->m_args[d].m_right, ok);
+                if (!ok || (v && !used.insert(v).second)) return false;
+            }
+            if (used.size() + 1 < loop_vars.size()) return false;
+        }
+        return true;
+    }
+
+    ASR::expr_t* make_constant(int64_t n, ASR::ttype_t *type, const Location &loc) {
+        return ASRUtils::EXPR(ASR::make_IntegerConstant_t(al, loc, n, type));
+    }
+
+    // Tiles the perfect nest starting at `root`, returns the new outermost
+    // loop or nullptr if the nest is left unchanged
+    ASR::stmt_t* tile_nest(ASR::DoLoop_t *root) {
+        nest.clear();
+        loop_vars.clear();
+        ASR::DoLoop_t *loop = root;
+        while (true) {
+            if (loop->m_name || loop->n_orelse > 0
+                    || !is_a<ASR::Var_t>(*loop->m_head.m_v)
+                    || !is_unit_step(loop->m_head.m_increment)) {
+                return nullptr;
+            }
+            ASR::symbol_t *v = var_sym(loop->m_head.m_v);
+            if (std::find(loop_vars.begin(), loop_vars.end(), v)
+                    != loop_vars.end()) {
+                return nullptr;
+            }
+            nest.push_back(loop);
+            loop_vars.push_back(v);
+            if (loop->n_body != 1 || !is_a<ASR::DoLoop_t>(*loop->m_body[0])) {
+                break;
+            }
+            loop = down_cast<ASR::DoLoop_t>(loop->m_body[0]);
+        }
+        size_t depth = nest.size();
+        if (depth < 2) return nullptr;
+
+        NestAccessCollector accesses;
+        ASR::DoLoop_t *innermost = nest.back();
+        for (size_t i = 0; i < innermost->n_body && accesses.ok; i++) {
+            if (!is_a<ASR::Assignment_t>(*innermost->m_body[i])) return nullptr;
+            accesses.collect_assignment(
+                *down_cast<ASR::Assignment_t>(innermost->m_body[i]));
+        }
+        if (!accesses.ok || !is_permutable(accesses)) return nullptr;
+        // The bounds must not depend on the loop variables or the arrays
+        // written in the nest
+        for (ASR::DoLoop_t *l : nest) {
+            NestAccessCollector head;
+            head.visit_expr(*l->m_head.m_start);
+            head.visit_expr(*l->m_head.m_end);
+            if (!head.ok || !head.items.empty()) return nullptr;
+            for (ASR::symbol_t *v : loop_vars) {
+                if (head.scalar_reads.count(v)) return nullptr;
+            }
+        }
+
+        // The innermost loop walks the first dimension of the most arrays
+        std::map<ASR::symbol_t*, size_t> contiguous;
+        std::set<ASR::symbol_t*> arrays;
+        int64_t element_size = 1;
+        for (auto &item : accesses.items) {
+            bool ok = true;
+            ASR::symbol_t *v = subscript_var(item.first->m_args[0].m_right, ok);
+            if (ok && v) contiguous[v]++;
+            ASR::symbol_t *x = var_sym(item.first->m_v);
+            if (arrays.insert(x).second) {
+                ASR::ttype_t *type = ASRUtils::extract_type(
+                    ASRUtils::symbol_type(ASRUtils::symbol_get_past_external(x)));
+                int64_t size = ASRUtils::extract_kind_from_ttype_t(type);
+                if (is_a<ASR::Complex_t>(*type)) size *= 2;
+                element_size = std::max(element_size, size);
+            }
+        }
+        size_t inner = depth - 1;
+        for (size_t i = 0; i < depth; i++) {
+            if (contiguous[loop_vars[i]] > contiguous[loop_vars[inner]]) {
+                inner = i;
+            }
+        }
+        std::vector<ASR::DoLoop_t*> order;
+        for (size_t i = 0; i < depth; i++) {
+            if (i != inner) order.push_back(nest[i]);
+        }
+        order.push_back(nest[inner]);
+
+        // Tiling only pays off if elements are used again by other iterations
+        // of an outer loop: an access does not use some loop variable (as
+        // `a(i,k)` above) or does not walk its first dimension in the
+        // innermost loop (as in a transpose). An elementwise nest is only
+        // interchanged.
+        bool reuse = false;
+        for (auto &item : accesses.items) {
+            std::set<ASR::symbol_t*> used;
+            for (size_t d = 0; d < item.first->n_args; d++) {
+                bool ok = true;
+                ASR::symbol_t *v = subscript_var(item.first->m_args[d].m_right, ok);
+                if (v) used.insert(v);
+                if (d == 0 && v != loop_vars[inner]) reuse = true;
+            }
+            if (used.size() < depth) reuse = true;
+        }
+
+        // A tile of each array fits into the cache
+        int64_t tile = std::sqrt(cache_size / (int64_t)(arrays.size() * element_size));
+        int64_t pow2 = 4;
+        while (pow2 * 2 <= tile) pow2 *= 2;
+        tile = pow2;
+        std::vector<bool> tiled;
+        bool any_tiled = false;
+        for (ASR::DoLoop_t *l : order) {
+            int64_t start, end;
+            bool small = !reuse || (constant_int(l->m_head.m_start, start)
+                && constant_int(l->m_head.m_end, end)
+                && end - start + 1 <= tile);
+            tiled.push_back(!small);
+            any_tiled = any_tiled || !small;
+        }
+        if (!any_tiled && inner == depth - 1) return nullptr;
+
+        // Build the nest from the inside out
+        Vec<ASR::stmt_t*> body;
+        body.from_pointer_n_copy(al, innermost->m_body, innermost->n_body);
+        std::vector<ASR::symbol_t*> tile_vars(depth, nullptr);
+        for (size_t i = 0; i < depth; i++) {
+            if (!tiled[i]) continue;
+            ASR::expr_t *v = order[i]->m_head.m_v;
+            const Location &loc = v->base.loc;
+            std::string name = current_scope->get_unique_name(
+                "__libasr_tile_" + std::string(ASRUtils::symbol_name(var_sym(v))));
+            ASR::symbol_t *tile_var = down_cast<ASR::symbol_t>(
+                ASRUtils::make_Variable_t_util(al, loc, current_scope,
+                    s2c(al, name), nullptr, 0, ASR::intentType::Local, nullptr,
+                    nullptr, ASR::storage_typeType::Default,
+                    ASRUtils::expr_type(v), nullptr, ASR::abiType::Source,
+                    ASR::accessType::Public, ASR::presenceType::Required,
+                    false));
+            current_scope->add_symbol(name, tile_var);
+            tile_vars[i] = tile_var;
+        }
+        // Every use of the bounds and the tile variables gets its own node,
+        // the original bounds end up in the tile loops
+        ASRUtils::ExprStmtDuplicator duplicator(al);
+        for (size_t i = depth; i > 0; i--) {
+            ASR::DoLoop_t *l = order[i - 1];
+            ASR::do_loop_head_t head = l->m_head;
+            if (tiled[i - 1]) {
+                // v = v_tile, min(v_tile + tile - 1, end)
+                const Location &loc = head.loc;
+                ASR::ttype_t *type = ASRUtils::expr_type(head.m_v);
+                auto tile_end = [&]() {
+                    return ASRUtils::EXPR(ASR::make_IntegerBinOp_t(al, loc,
+                        ASRUtils::EXPR(ASR::make_Var_t(al, loc, tile_vars[i - 1])),
+                        ASR::binopType::Add, make_constant(tile - 1, type, loc),
+                        type, nullptr));
+                };
+                ASR::ttype_t *logical = ASRUtils::TYPE(ASR::make_Logical_t(al, loc, 4));
+                ASR::expr_t *test = ASRUtils::EXPR(ASR::make_IntegerCompare_t(
+                    al, loc, tile_end(), ASR::cmpopType::LtE,
+                    duplicator.duplicate_expr(head.m_end), logical, nullptr));
+                head.m_start = ASRUtils::EXPR(ASR::make_Var_t(al, loc,
+                    tile_vars[i - 1]));
+                head.m_end = ASRUtils::EXPR(ASR::make_IfExp_t(al, loc, test,
+                    tile_end(), duplicator.duplicate_expr(head.m_end), type,
+                    nullptr));
+            }
+            ASR::stmt_t *new_loop = ASRUtils::STMT(ASR::make_DoLoop_t(al,
+                l->base.base.loc, nullptr, head, body.p, body.size(), nullptr, 0));
+            body.reserve(al, 1);
+            body.push_back(al, new_loop);
+        }
+        for (size_t i = depth; i > 0; i--) {
+            if (!tiled[i - 1]) continue;
+            ASR::DoLoop_t *l = order[i - 1];
+            ASR::do_loop_head_t head = l->m_head;
+            head.m_v = ASRUtils::EXPR(ASR::make_Var_t(al, head.m_v->base.loc,
+                tile_vars[i - 1]));
+            head.m_increment = make_constant(tile,
+                ASRUtils::expr_type(head.m_v), head.loc);
+            ASR::stmt_t *new_loop = ASRUtils::STMT(ASR::make_DoLoop_t(al,
+                l->base.base.loc, nullptr, head, body.p, body.size(), nullptr, 0));
+            body.reserve(al, 1);
+            body.push_back(al, new_loop);
+        }
+        return body[0];
+    }
+
+    void transform_stmts(ASR::stmt_t **&m_body, size_t &n_body) {
+        for (size_t i = 0; i < n_body; i++) {
+            if (is_a<ASR::DoLoop_t>(*m_body[i])) {
+                ASR::stmt_t *tiled = tile_nest(down_cast<ASR::DoLoop_t>(m_body[i]));
+                if (tiled) {
+                    m_body[i] = tiled;
+                    continue;
+                }
+            }
+            visit_stmt(*m_body[i]);
+        }
+    }
+};
+
+void pass_loop_tile(Allocator &al, ASR::TranslationUnit_t &unit,
+                    const PassOptions &pass_options) {
+    // The loop variables do not end up with their final values
+    if (pass_options.use_loop_variable_after_loop) return;
+    LoopTileVisitor v(al, pass_options.tile_cache_size);
+    v.visit_TranslationUnit(unit);
+}
+
+
+} // namespace LCompilers
@@ -0,0 +1,360 @@
+#include <libasr/asr.h>
+#include <libasr/containers.h>
+#include <libasr/exception.h>
+#include <libasr/asr_utils.h>
+#include <libasr/asr_verify.h>
+#include <libasr/asr_builder.h>
+#include <libasr/pass/matmul_kernel.h>
+#include <libasr/pass/pass_utils.h>
+#include <libasr/pass/intrinsic_array_function_registry.h>
+
+
+namespace LCompilers {
+
+using ASR::down_cast;
+using ASR::is_a;
+
+/*
+This ASR pass replaces `c = matmul(a, b)`, where `a`, `b` and `c` are real or
+complex arrays of the same kind, with a call to the matrix multiplication
+kernel of the runtime library (`_lfortran_sgemm`, `_lfortran_dgemm`,
+`_lfortran_cgemm` or `_lfortran_zgemm`), e.g.
+
+    if (size(c, 1) == size(a, 1) .and. size(c, 2) == size(b, 2) .and.
+            size(b, 1) == size(a, 2) .and. is_contiguous(a)) then
+        call _lfortran_dgemm(size(a, 1), size(b, 2), size(a, 2),
+            a(lbound(a, 1), lbound(a, 2)), size(a, 1),
+            b(lbound(b, 1), lbound(b, 2)), size(a, 2),
+            c(lbound(c, 1), lbound(c, 2)), size(a, 1))
+    else
+        c = matmul(a, b)
+    end if
+
+The kernels get the address of the first element of each array, so only
+arrays that are contiguous are passed; `is_contiguous` is checked at runtime
+for assumed shape arrays. Everything else is left to the `intrinsic_function`
+pass. The kernels accumulate every element in the same order as the loops
+that the `intrinsic_function` pass generates.
+
+With --blas=<lib>, real products with at least `blas_min_flops`
+multiplications call `cblas_sgemm`/`cblas_dgemm` of that library instead.
+With --fast, `s = dot_product(x, y)` of contiguous real vectors calls
+`_lfortran_sdot`/`_lfortran_ddot`, which add the products in a different
+order.
+
+The pass runs after `array_struct_temporary`, which assigns every `matmul`
+and `dot_product` in an expression to a temporary, and before
+`intrinsic_function`.
+*/
+
+namespace {
+
+// Real products with at least this many multiplications are computed by the
+// BLAS library given with --blas
+const int64_t blas_min_flops = 64*64*64;
+
+// CBLAS_ORDER::CblasColMajor and CBLAS_TRANSPOSE::CblasNoTrans
+const int64_t cblas_col_major = 102;
+const int64_t cblas_no_trans = 111;
+
+// The variable of `x` if it is a real or complex array that is not a pointer
+ASR::Variable_t* array_var(ASR::expr_t *x) {
+    if (!is_a<ASR::Var_t>(*x)) return nullptr;
+    ASR::symbol_t *s = ASRUtils::symbol_get_past_external(
+        down_cast<ASR::Var_t>(x)->m_v);
+    if (!is_a<ASR::Variable_t>(*s)) return nullptr;
+    ASR::Variable_t *v = down_cast<ASR::Variable_t>(s);
+    if (!ASRUtils::is_array(v->m_type) || ASRUtils::is_pointer(v->m_type)) {
+        return nullptr;
+    }
+    ASR::ttype_t *type = ASRUtils::type_get_past_array(
+        ASRUtils::type_get_past_allocatable(v->m_type));
+    if (!ASRUtils::is_real(*type) && !ASRUtils::is_complex(*type)) {
+        return nullptr;
+    }
+    int kind = ASRUtils::extract_kind_from_ttype_t(type);
+    if (kind != 4 && kind != 8) return nullptr;
+    return v;
+}
+
+ASR::ttype_t* element_type(ASR::ttype_t *type) {
+    return ASRUtils::type_get_past_array(
+        ASRUtils::type_get_past_allocatable(type));
+}
+
+bool same_element_type(ASR::ttype_t *x, ASR::ttype_t *y) {
+    x = element_type(x);
+    y = element_type(y);
+    return x->type == y->type && ASRUtils::extract_kind_from_ttype_t(x)
+        == ASRUtils::extract_kind_from_ttype_t(y);
+}
+
+// Assumed shape arrays can be sections that are not contiguous, all other
+// arrays are
+bool may_be_strided(ASR::Variable_t *v) {
+    return !ASRUtils::is_allocatable(v->m_type)
+        && ASRUtils::extract_physical_type(v->m_type)
+            == ASR::array_physical_typeType::DescriptorArray;
+}
+
+// The one letter BLAS prefix of the element type: s, d, c or z
+std::string blas_prefix(ASR::ttype_t *type) {
+    type = element_type(type);
+    int kind = ASRUtils::extract_kind_from_ttype_t(type);
+    if (ASRUtils::is_real(*type)) {
+        return kind == 4 ? "s" : "d";
+    }
+    return kind == 4 ? "c" : "z";
+}
+
+}
+
+class MatMulKernelVisitor : public ASR::ASRPassBaseWalkVisitor<MatMulKernelVisitor>
+{
+private:
+    Allocator &al;
+    const PassOptions &pass_options;
+
+public:
+    MatMulKernelVisitor(Allocator &al_, const PassOptions &pass_options_)
+        : al(al_), pass_options(pass_options_) { }
+
+    // The BindC interface to the C function `c_name` in the current scope.
+    // The arguments with `by_value[i]` set are passed by value, the others
+    // by reference.
+    ASR::symbol_t* c_interface(const Location &loc, const std::string &c_name,
+            const std::vector<ASR::ttype_t*> &arg_types,
+            const std::vector<bool> &by_value, ASR::ttype_t *return_type) {
+        std::string name = "_lcompilers_" + c_name;
+        ASR::symbol_t *s = current_scope->get_symbol(name);
+        if (s) return s;
+        ASRUtils::ASRBuilder b(al, loc);
+        SymbolTable *fn_symtab = al.make_new<SymbolTable>(current_scope);
+        Vec<ASR::expr_t*> args; args.reserve(al, arg_types.size());
+        for (size_t i = 0; i < arg_types.size(); i++) {
+            // Array elements are passed by reference only to arguments
+            // that are not intent(in)
+            args.push_back(al, b.Variable(fn_symtab, "x_" + std::to_string(i),
+                arg_types[i], by_value[i] ? ASR::intentType::In
+                : ASR::intentType::InOut, ASR::abiType::BindC, by_value[i]));
+        }
+        ASR::expr_t *return_var = nullptr;
+        if (return_type) {
+            return_var = b.Variable(fn_symtab, name, return_type,
+                ASRUtils::intent_return_var, ASR::abiType::BindC, false);
+        }
+        SetChar dep; dep.reserve(al, 1);
+        Vec<ASR::stmt_t*> body; body.reserve(al, 1);
+        s = make_ASR_Function_t(name, fn_symtab, dep, args, body, return_var,
+            ASR::abiType::BindC, ASR::deftypeType::Interface, s2c(al, c_name));
+        current_scope->add_symbol(name, s);
+        return s;
+    }
+
+    Vec<ASR::call_arg_t> call_args(const std::vector<ASR::expr_t*> &args) {
+        Vec<ASR::call_arg_t> call_args; call_args.reserve(al, args.size());
+        for (ASR::expr_t *arg : args) {
+            ASR::call_arg_t call_arg;
+            call_arg.loc = arg->base.loc;
+            call_arg.m_value = arg;
+            call_args.push_back(al, call_arg);
+        }
+        return call_args;
+    }
+
+    // A new reference to the variable `x`, so that no node is shared
+    ASR::expr_t* var(ASR::expr_t *x) {
+        return ASRUtils::EXPR(ASR::make_Var_t(al, x->base.loc,
+            down_cast<ASR::Var_t>(x)->m_v));
+    }
+
+    // The first element of the array `x`
+    ASR::expr_t* first_element(ASRUtils::ASRBuilder &b, ASR::expr_t *x) {
+        std::vector<ASR::expr_t*> idx;
+        int rank = ASRUtils::extract_n_dims_from_ttype(ASRUtils::expr_type(x));
+        for (int i = 1; i <= rank; i++) {
+            idx.push_back(b.ArrayLBound(var(x), i));
+        }
+        return b.ArrayItem_01(var(x), idx);
+    }
+
+    ASR::expr_t* size(ASRUtils::ASRBuilder &b, ASR::expr_t *x, int dim) {
+        return b.ArraySize(var(x), b.i32(dim), ASRUtils::TYPE(
+            ASR::make_Integer_t(al, x->base.loc, 4)));
+    }
+
+    ASR::expr_t* is_contiguous(const Location &loc, ASR::expr_t *x) {
+        return ASRUtils::EXPR(ASR::make_ArrayIsContiguous_t(al, loc, var(x),
+            logical, nullptr));
+    }
+
+    void replace_matmul(ASR::Assignment_t &x,
+            ASR::IntrinsicArrayFunction_t &f, std::vector<ASR::stmt_t*> &out) {
+        const Location &loc = x.base.base.loc;
+        ASR::expr_t *a = f.m_args[0], *b_ = f.m_args[1], *c = x.m_target;
+        ASR::Variable_t *va = array_var(a), *vb = array_var(b_),
+            *vc = array_var(c);
+        // `c = matmul(c, b)` is assigned to a temporary by
+        // `array_struct_temporary`, but check anyway
+        if (!va || !vb || !vc || vc == va || vc == vb) return;
+        if (!same_element_type(vc->m_type, va->m_type)
+                || !same_element_type(vc->m_type, vb->m_type)) {
+            return;
+        }
+        ASRUtils::ASRBuilder b(al, loc);
+        int rank_a = ASRUtils::extract_n_dims_from_ttype(va->m_type);
+        int rank_b = ASRUtils::extract_n_dims_from_ttype(vb->m_type);
+        // matmul(a(k), b(k, n)) is a 1 x n product and
+        // matmul(a(m, k), b(k)) an m x 1 product. Every use gets its own
+        // expression.
+        auto m = [&]() { return rank_a == 2 ? size(b, a, 1) : b.i32(1); };
+        auto k = [&]() { return size(b, a, rank_a); };
+        auto n = [&]() { return rank_b == 2 ? size(b, b_, 2) : b.i32(1); };
+
+        Vec<ASR::dimension_t> c_dims; c_dims.reserve(al, 2);
+        ASR::expr_t *cond = b.Eq(size(b, b_, 1), k());
+        if (rank_a == 2) {
+            c_dims.push_back(al, b.set_dim(b.i32(1), m()));
+            cond = b.And(cond, b.Eq(size(b, c, 1), m()));
+        }
+        if (rank_b == 2) {
+            c_dims.push_back(al, b.set_dim(b.i32(1), n()));
+            cond = b.And(cond, b.Eq(size(b, c, c_dims.size()), n()));
+        }
+        for (auto &arr : {std::make_pair(a, va), std::make_pair(b_, vb),
+                std::make_pair(c, vc)}) {
+            if (may_be_strided(arr.second)) {
+                cond = b.And(cond, is_contiguous(loc, arr.first));
+            }
+        }
+
+        ASR::ttype_t *elem = element_type(vc->m_type);
+        std::string prefix = blas_prefix(vc->m_type);
+        auto gemm_args = [&]() {
+            return std::vector<ASR::expr_t*>{m(), n(), k(),
+                first_element(b, a), m(), first_element(b, b_), k(),
+                first_element(b, c), m()};
+        };
+        std::vector<ASR::ttype_t*> types = {int32, int32, int32,
+            elem, int32, elem, int32, elem, int32};
+        std::vector<bool> by_value = {true, true, true,
+            false, true, false, true, false, true};
+        ASR::symbol_t *kernel = c_interface(loc, "_lfortran_" + prefix + "gemm",
+            types, by_value, nullptr);
+        Vec<ASR::call_arg_t> kernel_args = call_args(gemm_args());
+        ASR::stmt_t *call = b.SubroutineCall(kernel, kernel_args);
+        if (!pass_options.blas.empty() && ASRUtils::is_real(*elem)) {
+            std::vector<ASR::expr_t*> args = gemm_args();
+            args.insert(args.begin(), {b.i32(cblas_col_major),
+                b.i32(cblas_no_trans), b.i32(cblas_no_trans)});
+            args.insert(args.begin() + 6, b.f_t(1, elem));
+            args.insert(args.begin() + 11, b.f_t(0, elem));
+            types.insert(types.begin(), {int32, int32, int32});
+            types.insert(types.begin() + 6, elem);
+            types.insert(types.begin() + 11, elem);
+            by_value.insert(by_value.begin(), {true, true, true});
+            by_value.insert(by_value.begin() + 6, true);
+            by_value.insert(by_value.begin() + 11, true);
+            ASR::symbol_t *blas = c_interface(loc, "cblas_" + prefix + "gemm",
+                types, by_value, nullptr);
+            Vec<ASR::call_arg_t> blas_args = call_args(args);
+            ASR::expr_t *flops = b.Mul(b.Mul(b.i2i_t(m(), int64),
+                b.i2i_t(n(), int64)), b.i2i_t(k(), int64));
+            call = b.If(b.GtE(flops, b.i64(blas_min_flops)),
+                {b.SubroutineCall(blas, blas_args)}, {call});
+        }
+
+        if (ASRUtils::is_allocatable(vc->m_type)) {
+            // Allocate `c` as `matmul` would, so that its size can be checked
+            Vec<ASR::expr_t*> alloc_args; alloc_args.reserve(al, 1);
+            alloc_args.push_back(al, var(c));
+            ASR::expr_t *allocated = ASRUtils::EXPR(
+                ASR::make_IntrinsicImpureFunction_t(al, loc,
+                static_cast<int64_t>(ASRUtils::IntrinsicImpureFunctions::Allocated),
+                alloc_args.p, alloc_args.n, 0,
+                logical, nullptr));
+            out.push_back(b.If(b.Not(allocated), {b.Allocate(var(c), c_dims)}, {}));
+        }
+        out.push_back(b.If(cond, {call}, {&x.base}));
+    }
+
+    void replace_dot_product(ASR::Assignment_t &x,
+            ASR::IntrinsicArrayFunction_t &f, std::vector<ASR::stmt_t*> &out) {
+        const Location &loc = x.base.base.loc;
+        ASR::expr_t *u = f.m_args[0], *v = f.m_args[1];
+        ASR::Variable_t *vu = array_var(u), *vv = array_var(v);
+        ASR::ttype_t *target_type = ASRUtils::expr_type(x.m_target);
+        if (!vu || !vv || ASRUtils::is_array(target_type)
+                || !ASRUtils::is_real(*element_type(vu->m_type))
+                || !same_element_type(vu->m_type, vv->m_type)
+                || !same_element_type(vu->m_type, target_type)) {
+            return;
+        }
+        ASRUtils::ASRBuilder b(al, loc);
+        ASR::ttype_t *elem = element_type(vu->m_type);
+        ASR::expr_t *cond = b.Eq(size(b, v, 1), size(b, u, 1));
+        for (auto &arr : {std::make_pair(u, vu), std::make_pair(v, vv)}) {
+            if (may_be_strided(arr.second)) {
+                cond = b.And(cond, is_contiguous(loc, arr.first));
+            }
+        }
+        ASR::symbol_t *kernel = c_interface(loc,
+            "_lfortran_" + blas_prefix(elem) + "dot", {int32, elem, elem},
+            {true, false, false}, elem);
+        Vec<ASR::call_arg_t> args = call_args({size(b, u, 1), first_element(b, u),
+            first_element(b, v)});
+        out.push_back(b.If(cond, {b.Assignment(x.m_target,
+            b.Call(kernel, args, elem))}, {&x.base}));
+    }
+
+    void replace(ASR::Assignment_t &x, std::vector<ASR::stmt_t*> &out) {
+        if (!is_a<ASR::IntrinsicArrayFunction_t>(*x.m_value)
+                || ASRUtils::expr_value(x.m_value)) {
+            return;
+        }
+        ASR::IntrinsicArrayFunction_t &f =
+            *down_cast<ASR::IntrinsicArrayFunction_t>(x.m_value);
+        if (f.n_args != 2) return;
+        switch (static_cast<ASRUtils::IntrinsicArrayFunctions>(
+                f.m_arr_intrinsic_id)) {
+            case ASRUtils::IntrinsicArrayFunctions::MatMul:
+                replace_matmul(x, f, out);
+                break;
+            case ASRUtils::IntrinsicArrayFunctions::DotProduct:
+                if (pass_options.fast) replace_dot_product(x, f, out);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void transform_stmts(ASR::stmt_t **&m_body, size_t &n_body) {
+        Vec<ASR::stmt_t*> body;
+        body.reserve(al, n_body);
+        for (size_t i = 0; i < n_body; i++) {
+            std::vector<ASR::stmt_t*> out;
+            if (is_a<ASR::Assignment_t>(*m_body[i])) {
+                replace(*down_cast<ASR::Assignment_t>(m_body[i]), out);
+            }
+            if (out.empty()) {
+                visit_stmt(*m_body[i]);
+                body.push_back(al, m_body[i]);
+            } else {
+                for (ASR::stmt_t *s : out) body.push_back(al, s);
+            }
+        }
+        m_body = body.p;
+        n_body = body.size();
+    }
+};
+
+void pass_matmul_kernel(Allocator &al, ASR::TranslationUnit_t &unit,
+                        const PassOptions &pass_options) {
+    MatMulKernelVisitor v(al, pass_options);
+    v.visit_TranslationUnit(unit);
+    PassUtils::UpdateDependenciesVisitor u(al);
+    u.visit_TranslationUnit(unit);
+}
+
+
+} // namespace LCompilers
@@ -6,6 +6,7 @@
 #include <libasr/asr.h>
 #include <libasr/string_utils.h>
 #include <libasr/alloc.h>
+#include <libasr/trace.h>
 
 // TODO: Remove lpython/lfortran includes, make it compiler agnostic
 #if __has_include(<lfortran/utils.h>)
@@ -36,6 +37,9 @@
 #include <libasr/pass/replace_intrinsic_subroutine.h>
 #include <libasr/pass/replace_fma.h>
 #include <libasr/pass/loop_unroll.h>
+#include <libasr/pass/loop_fusion.h>
+#include <libasr/pass/loop_tile.h>
+#include <libasr/pass/matmul_kernel.h>
 #include <libasr/pass/replace_sign_from_value.h>
 #include <libasr/pass/replace_class_constructor.h>
 #include <libasr/pass/unused_functions.h>
@@ -64,7 +68,12 @@
 #include <libasr/asr_verify.h>
 #include <libasr/pickle.h>
 
+#include <atomic>
+#include <exception>
 #include <map>
+#include <memory>
+#include <optional>
+#include <thread>
 #include <vector>
 #include <algorithm>
 #include <fstream>
@@ -74,6 +83,9 @@ namespace LCompilers {
     typedef void (*pass_function)(Allocator&, ASR::TranslationUnit_t&,
                                   const LCompilers::PassOptions&);
 
+    typedef void (*procedure_pass_function)(Allocator&, ASR::symbol_t&,
+                                  const LCompilers::PassOptions&);
+
     class PassManager {
         private:
 
@@ -81,6 +93,8 @@ namespace LCompilers {
         std::vector<std::string> _optimization_passes;
         std::vector<std::string> _user_defined_passes;
         std::vector<std::string> _skip_passes, _c_skip_passes;
+        // Passes of `_passes` that only run with --fast (or with --pass)
+        std::vector<std::string> _fast_passes;
         std::map<std::string, pass_function> _passes_db = {
             {"replace_with_compile_time_values", &pass_replace_with_compile_time_values},
             {"do_loops", &pass_replace_do_loops},
@@ -102,6 +116,9 @@ namespace LCompilers {
             {"sign_from_value", &pass_replace_sign_from_value},
             {"inline_function_calls", &pass_inline_function_calls},
             {"loop_unroll", &pass_loop_unroll},
+            {"loop_fusion", &pass_loop_fusion},
+            {"loop_tile", &pass_loop_tile},
+            {"matmul_kernel", &pass_matmul_kernel},
             {"dead_code_removal", &pass_dead_code_removal},
             {"forall", &pass_replace_for_all},
             {"select_case", &pass_replace_select_case},
@@ -124,6 +141,16 @@ namespace LCompilers {
             {"array_struct_temporary", &pass_array_struct_temporary}
         };
 
+        // Passes that only transform the statements of one procedure at a
+        // time: they do not add symbols, symbol tables or nodes outside of
+        // the procedure. They can be applied to several procedures
+        // concurrently, see `apply_procedure_pass()`.
+        std::map<std::string, procedure_pass_function> _procedure_passes_db = {
+            {"do_loops", &pass_replace_do_loops_in_procedure},
+            {"forall", &pass_replace_for_all_in_procedure},
+            {"where", &pass_replace_where_in_procedure},
+        };
+
         bool apply_default_passes;
         bool c_skip_pass; // This will contain the passes that are to be skipped in C
 
@@ -179,6 +206,10 @@ namespace LCompilers {
                 // it
 
                 if (rtlib && passes[i] == "unused_functions") continue;
+                // Only with --fast, or if requested with --pass
+                if (!pass_options.fast && _user_defined_passes.empty()
+                        && std::find(_fast_passes.begin(), _fast_passes.end(),
+                            passes[i]) != _fast_passes.end()) continue;
                 if( std::find(_skip_passes.begin(), _skip_passes.end(), passes[i]) != _skip_passes.end())
                     continue;
                 if (c_skip_pass && std::find(_c_skip_passes.begin(),
@@ -188,7 +219,18 @@ namespace LCompilers {
                     std::cerr << "ASR Pass starts: '" << passes[i] << "'\n";
                 }
                 auto t1 = std::chrono::high_resolution_clock::now();
-                _passes_db[passes[i]](al, *asr, pass_options);
+                // Only built if tracing is enabled, so that the name is not
+                // concatenated for every pass otherwise
+                std::optional<trace::Scope> trace_scope;
+                if (trace::enabled()) trace_scope.emplace("[PASS]" + passes[i]);
+                auto procedure_pass = _procedure_passes_db.find(passes[i]);
+                if (pass_options.pass_threads <= 1
+                        || procedure_pass == _procedure_passes_db.end()
+                        || !apply_procedure_pass(al, *asr,
+                            procedure_pass->second, pass_options)) {
+                    _passes_db[passes[i]](al, *asr, pass_options);
+                }
+                trace_scope.reset();
 #if defined(WITH_LFORTRAN_ASSERT)
                 if (!asr_verify(*asr, true, diagnostics)) {
                     std::cerr << diagnostics.render2();
@@ -209,12 +251,118 @@ namespace LCompilers {
                     pass_options.vector_of_time_report.push_back(message);
                     cummulative_time_taken_by_passes_in_microseconds += (double) std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
                 }
+                record_memory_usage(pass_options, "[PASS]" + passes[i], al);
                 if (pass_options.verbose) {
                     std::cerr << "ASR Pass ends: '" << passes[i] << "'\n";
                 }
             }
         }
 
+        /* Applies the procedure pass `pass` to the procedures of `asr` (the
+         * programs, the functions of the modules and the global functions)
+         * on `pass_options.pass_threads` threads. Every thread takes the next
+         * procedure from a shared index and allocates the new nodes in its
+         * own Allocator, whose memory is adopted by `al` at the end. As every
+         * procedure is transformed independently, the result is the same as
+         * applying the pass to the whole unit.
+         *
+         * Returns false without changing `asr` if it contains statements
+         * outside of procedures (global statements, templates, ...); the
+         * caller then applies the pass to the whole unit.
+         */
+        bool apply_procedure_pass(Allocator& al, ASR::TranslationUnit_t& asr,
+                procedure_pass_function pass, const PassOptions& pass_options) {
+            if (asr.n_items > 0) return false;
+            // Symbols that cannot contain statements
+            auto no_statements = [](const ASR::symbol_t &s) {
+                switch (s.type) {
+                    case ASR::symbolType::Variable:
+                    case ASR::symbolType::ExternalSymbol:
+                    case ASR::symbolType::GenericProcedure:
+                    case ASR::symbolType::CustomOperator:
+                    case ASR::symbolType::ClassProcedure:
+                    case ASR::symbolType::Struct:
+                    case ASR::symbolType::Enum:
+                    case ASR::symbolType::Union:
+                        return true;
+                    default:
+                        return false;
+                }
+            };
+            std::vector<ASR::symbol_t*> procedures;
+            // Like the walks over the ASR, only the loaded symbols: a lazily
+            // loaded module is not loaded completely
+            for (auto &item : asr.m_symtab->get_loaded_scope()) {
+                ASR::symbol_t *sym = item.second;
+                if (ASR::is_a<ASR::Module_t>(*sym)) {
+                    ASR::Module_t *m = ASR::down_cast<ASR::Module_t>(sym);
+                    for (auto &item2 : m->m_symtab->get_loaded_scope()) {
+                        if (ASR::is_a<ASR::Function_t>(*item2.second)) {
+                            procedures.push_back(item2.second);
+                        } else if (!no_statements(*item2.second)) {
+                            return false;
+                        }
+                    }
+                } else if (ASR::is_a<ASR::Function_t>(*sym)
+                        || ASR::is_a<ASR::Program_t>(*sym)) {
+                    procedures.push_back(sym);
+                } else if (!no_statements(*sym)) {
+                    return false;
+                }
+            }
+            size_t n_threads = std::min<size_t>(pass_options.pass_threads,
+                procedures.size());
+            if (n_threads <= 1) return false;
+            // The threads record the changes of their symbol tables in the
+            // global scope: only `untracked_changes` is thread safe, a list
+            // of changed symbol tables must not be attached
+            LCOMPILERS_ASSERT(!asr.m_symtab->tracks_changes())
+            std::vector<std::unique_ptr<Allocator>> allocators(n_threads);
+            std::vector<std::exception_ptr> errors(n_threads);
+            std::atomic<size_t> next{0};
+            auto worker = [&](size_t t) {
+                try {
+                    size_t i;
+                    while ((i = next++) < procedures.size()) {
+                        pass(*allocators[t], *procedures[i], pass_options);
+                    }
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                    // Stop the other threads
+                    next = procedures.size();
+                }
+            };
+            for (size_t t = 0; t < n_threads; t++) {
+                allocators[t] = std::make_unique<Allocator>(1024*1024);
+            }
+            std::vector<std::thread> threads;
+            for (size_t t = 1; t < n_threads; t++) {
+                threads.emplace_back(worker, t);
+            }
+            worker(0);
+            for (auto &thread : threads) thread.join();
+            LCOMPILERS_ASSERT(!asr.m_symtab->tracks_changes())
+            // The transformed procedures reference the memory of all
+            // threads, also if one of them failed
+            for (auto &a : allocators) al.adopt(*a);
+            for (auto &error : errors) {
+                if (error) std::rethrow_exception(error);
+            }
+            return true;
+        }
+
+        // The state that selects the passes `apply_passes()` runs, for keys
+        // of cached compilations
+        std::string fingerprint() const {
+            std::string s = "default=" + std::to_string(apply_default_passes)
+                + " c=" + std::to_string(c_skip_pass)
+                + " rtlib=" + std::to_string(rtlib) + "\npasses=";
+            for (auto &pass : _user_defined_passes) s += pass + ",";
+            s += "\nskip_passes=";
+            for (auto &pass : _skip_passes) s += pass + ",";
+            return s + "\n";
+        }
+
         void _parse_pass_arg(std::string& arg, std::vector<std::string>& passes) {
             if (arg == "") return;
 
@@ -258,9 +406,12 @@ namespace LCompilers {
                 "subroutine_from_function",
                 "array_op",
                 "symbolic",
+                "matmul_kernel",
                 "intrinsic_function",
                 "intrinsic_subroutine",
                 "array_op",
+                "loop_fusion",
+                "loop_tile",
                 "pass_array_by_data",
                 "array_passed_in_function_call",
                 "print_struct_type",
@@ -295,7 +446,14 @@ namespace LCompilers {
                 "print_list_tuple",
                 "do_loops",
                 "select_case",
-                "inline_function_calls"
+                "inline_function_calls",
+                // The C backend has no `is_contiguous`
+                "matmul_kernel"
+            };
+            _fast_passes = {
+                "matmul_kernel",
+                "loop_fusion",
+                "loop_tile"
             };
             _user_defined_passes.clear();
         }
@@ -359,6 +517,8 @@ namespace LCompilers {
                 // Note: this is not enough for rtlib, we also need to include
                 // it
                 if( std::find(_skip_passes.begin(), _skip_passes.end(), passes[i]) != _skip_passes.end()) continue;
+                if (!pass_options.fast && std::find(_fast_passes.begin(),
+                        _fast_passes.end(), passes[i]) != _fast_passes.end()) continue;
                 if (pass_options.verbose) {
                     std::cerr << "ASR Pass starts: '" << passes[i] << "'\n";
                 }
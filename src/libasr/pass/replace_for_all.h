@@ -9,6 +9,11 @@ namespace LCompilers {
     void pass_replace_for_all(Allocator &al, ASR::TranslationUnit_t &unit,
                                 const PassOptions &pass_options);
 
+    // Applies the pass to a single Program or Function (and the procedures
+    // nested in it), see `PassManager::apply_procedure_pass()`
+    void pass_replace_for_all_in_procedure(Allocator &al, ASR::symbol_t &procedure,
+                                const PassOptions &pass_options);
+
 } // namespace LCompilers
 
 #endif // LIBASR_PASS_REPLACE_FOR_ALL_H
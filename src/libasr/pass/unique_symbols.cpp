@@ -311,7 +311,7 @@ class UniqueSymbolVisitor: public ASR::BaseWalkVisitor<UniqueSymbolVisitor> {
 
     public:
     std::unordered_map<ASR::symbol_t*, std::string>& sym_to_new_name;
-    std::map<std::string, ASR::symbol_t*> current_scope;
+    std::map<std::string, ASR::symbol_t*, std::less<>> current_scope;
 
     UniqueSymbolVisitor(Allocator& al_,
     std::unordered_map<ASR::symbol_t*, std::string> &sn) : al(al_), sym_to_new_name(sn){}
@@ -319,7 +319,7 @@ class UniqueSymbolVisitor: public ASR::BaseWalkVisitor<UniqueSymbolVisitor> {
 
     void visit_TranslationUnit(const ASR::TranslationUnit_t &x) {
         ASR::TranslationUnit_t& xx = const_cast<ASR::TranslationUnit_t&>(x);
-        std::map<std::string, ASR::symbol_t*> current_scope_copy = current_scope;
+        auto current_scope_copy = current_scope;
         current_scope = x.m_symtab->get_scope();
         for (auto &a : xx.m_symtab->get_scope()) {
             visit_symbol(*a.second);
@@ -336,7 +336,7 @@ class UniqueSymbolVisitor: public ASR::BaseWalkVisitor<UniqueSymbolVisitor> {
     template <typename T>
     void update_symbols_1(const T &x) {
         T& xx = const_cast<T&>(x);
-        std::map<std::string, ASR::symbol_t*> current_scope_copy = current_scope;
+        auto current_scope_copy = current_scope;
         ASR::symbol_t *sym = ASR::down_cast<ASR::symbol_t>((ASR::asr_t*)&x);
         if (sym_to_new_name.find(sym) != sym_to_new_name.end()) {
             xx.m_name = s2c(al, sym_to_new_name[sym]);
@@ -413,7 +413,7 @@ class UniqueSymbolVisitor: public ASR::BaseWalkVisitor<UniqueSymbolVisitor> {
         if (sym_to_new_name.find(sym) != sym_to_new_name.end()) {
             xx.m_name = s2c(al, sym_to_new_name[sym]);
         }
-        std::map<std::string, ASR::symbol_t*> current_scope_copy = current_scope;
+        auto current_scope_copy = current_scope;
         for (size_t i=0; i<xx.n_dependencies; i++) {
             if (current_scope.find(xx.m_dependencies[i]) != current_scope.end()) {
                 sym = current_scope[xx.m_dependencies[i]];
@@ -477,7 +477,7 @@ class UniqueSymbolVisitor: public ASR::BaseWalkVisitor<UniqueSymbolVisitor> {
         if (sym_to_new_name.find(sym) != sym_to_new_name.end()) {
             xx.m_name = s2c(al, sym_to_new_name[sym]);
         }
-        std::map<std::string, ASR::symbol_t*> current_scope_copy = current_scope;
+        auto current_scope_copy = current_scope;
         current_scope = x.m_symtab->get_scope();
         for (auto &a : x.m_symtab->get_scope()) {
             visit_symbol(*a.second);
@@ -506,7 +506,7 @@ class UniqueSymbolVisitor: public ASR::BaseWalkVisitor<UniqueSymbolVisitor> {
         if (sym_to_new_name.find(sym) != sym_to_new_name.end()) {
             xx.m_name = s2c(al, sym_to_new_name[sym]);
         }
-        std::map<std::string, ASR::symbol_t*> current_scope_copy = current_scope;
+        auto current_scope_copy = current_scope;
         current_scope = x.m_symtab->get_scope();
         for (auto &a : x.m_symtab->get_scope()) {
             visit_symbol(*a.second);
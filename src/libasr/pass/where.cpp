@@ -119,5 +119,11 @@ void pass_replace_where(Allocator &al, ASR::TranslationUnit_t &unit,
     v.visit_TranslationUnit(unit);
 }
 
+void pass_replace_where_in_procedure(Allocator &al, ASR::symbol_t &procedure,
+                        const LCompilers::PassOptions& /*pass_options*/) {
+    TransformWhereVisitor v(al);
+    v.visit_symbol(procedure);
+}
+
 
 } // namespace LCompilers
@@ -110,6 +110,201 @@ LFORTRAN_API double _lfortran_sum(int n, double *v)
     return r;
 }
 
+// Matrix multiplication kernels, C = A*B for column major A (m x k),
+// B (k x n) and C (m x n) with leading dimensions lda, ldb and ldc.
+//
+// The real kernels pack a KC x NC panel of B into NR wide slivers and an
+// MC x KC block of A into MR high slivers, so that the micro kernel reads
+// both sequentially from cache and keeps an MR x NR block of C in
+// registers. Its innermost loop is vectorized by the C compiler. Every
+// element of C is accumulated over k in the same order as the naive loop,
+// so the result does not depend on the blocking as long as the C compiler
+// does not contract `acc + a*b` into fused multiply-adds, which is turned
+// off for the kernels below.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC optimize ("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract (off)
+#endif
+
+#define LFORTRAN_GEMM_MR 8
+#define LFORTRAN_GEMM_NR 4
+#define LFORTRAN_GEMM_MC 128
+#define LFORTRAN_GEMM_KC 256
+#define LFORTRAN_GEMM_NC 1024
+// Products with fewer multiplications than this (and matrix-vector
+// products) are not packed
+#define LFORTRAN_GEMM_SMALL (32*32*32)
+
+#define LFORTRAN_DEFINE_GEMM(NAME, T)                                          \
+static void NAME##_micro(int32_t kc, const T *ap, const T *bp, T *c,           \
+        int64_t ldc, int32_t mr, int32_t nr, bool first)                       \
+{                                                                              \
+    T acc[LFORTRAN_GEMM_NR][LFORTRAN_GEMM_MR] = {{0}};                         \
+    int32_t i, j, p;                                                           \
+    if (!first) {                                                              \
+        for (j = 0; j < nr; j++) {                                             \
+            for (i = 0; i < mr; i++) acc[j][i] = c[i + j*ldc];                 \
+        }                                                                      \
+    }                                                                          \
+    for (p = 0; p < kc; p++) {                                                 \
+        const T *a_p = ap + (int64_t)p*LFORTRAN_GEMM_MR;                       \
+        const T *b_p = bp + (int64_t)p*LFORTRAN_GEMM_NR;                       \
+        for (j = 0; j < LFORTRAN_GEMM_NR; j++) {                               \
+            T b_pj = b_p[j];                                                   \
+            for (i = 0; i < LFORTRAN_GEMM_MR; i++) acc[j][i] += a_p[i] * b_pj; \
+        }                                                                      \
+    }                                                                          \
+    for (j = 0; j < nr; j++) {                                                 \
+        for (i = 0; i < mr; i++) c[i + j*ldc] = acc[j][i];                     \
+    }                                                                          \
+}                                                                              \
+                                                                               \
+LFORTRAN_API void NAME(int32_t m, int32_t n, int32_t k, T *a, int32_t lda,     \
+        T *b, int32_t ldb, T *c, int32_t ldc)                                  \
+{                                                                              \
+    int32_t i, j, p, ic, jc, pc, ir, jr;                                       \
+    T *ap = NULL, *bp = NULL;                                                  \
+    if (m <= 0 || n <= 0) return;                                              \
+    if (n > 1 && m > 1 && k > 0                                                \
+            && (int64_t)m*n*k >= LFORTRAN_GEMM_SMALL) {                        \
+        ap = (T*) malloc(sizeof(T) * LFORTRAN_GEMM_MC * LFORTRAN_GEMM_KC);     \
+        bp = (T*) malloc(sizeof(T) * LFORTRAN_GEMM_KC * LFORTRAN_GEMM_NC);     \
+        if (ap == NULL || bp == NULL) {                                        \
+            /* Out of memory: compute the product without packing */           \
+            free(ap);                                                          \
+            free(bp);                                                          \
+            ap = NULL;                                                         \
+        }                                                                      \
+    }                                                                          \
+    if (ap == NULL) {                                                          \
+        for (j = 0; j < n; j++) {                                              \
+            T *c_j = c + (int64_t)j*ldc;                                       \
+            for (i = 0; i < m; i++) c_j[i] = 0;                                \
+            for (p = 0; p < k; p++) {                                          \
+                const T *a_p = a + (int64_t)p*lda;                             \
+                T b_pj = b[p + (int64_t)j*ldb];                                \
+                for (i = 0; i < m; i++) c_j[i] += a_p[i] * b_pj;               \
+            }                                                                  \
+        }                                                                      \
+        return;                                                                \
+    }                                                                          \
+    for (jc = 0; jc < n; jc += LFORTRAN_GEMM_NC) {                             \
+        int32_t nc = n - jc < LFORTRAN_GEMM_NC ? n - jc : LFORTRAN_GEMM_NC;    \
+        for (pc = 0; pc < k; pc += LFORTRAN_GEMM_KC) {                         \
+            int32_t kc = k - pc < LFORTRAN_GEMM_KC ? k - pc : LFORTRAN_GEMM_KC;\
+            for (jr = 0; jr < nc; jr += LFORTRAN_GEMM_NR) {                    \
+                T *bp_r = bp + (int64_t)jr*kc;                                 \
+                for (p = 0; p < kc; p++) {                                     \
+                    for (j = 0; j < LFORTRAN_GEMM_NR; j++) {                   \
+                        bp_r[p*LFORTRAN_GEMM_NR + j] = jr + j < nc ?           \
+                            b[pc + p + (int64_t)(jc + jr + j)*ldb] : 0;        \
+                    }                                                          \
+                }                                                              \
+            }                                                                  \
+            for (ic = 0; ic < m; ic += LFORTRAN_GEMM_MC) {                     \
+                int32_t mc = m - ic < LFORTRAN_GEMM_MC ? m - ic                \
+                    : LFORTRAN_GEMM_MC;                                        \
+                for (ir = 0; ir < mc; ir += LFORTRAN_GEMM_MR) {                \
+                    T *ap_r = ap + (int64_t)ir*kc;                             \
+                    for (p = 0; p < kc; p++) {                                 \
+                        const T *a_p = a + ic + ir + (int64_t)(pc + p)*lda;    \
+                        for (i = 0; i < LFORTRAN_GEMM_MR; i++) {               \
+                            ap_r[p*LFORTRAN_GEMM_MR + i] = ir + i < mc ?       \
+                                a_p[i] : 0;                                    \
+                        }                                                      \
+                    }                                                          \
+                }                                                              \
+                for (jr = 0; jr < nc; jr += LFORTRAN_GEMM_NR) {                \
+                    for (ir = 0; ir < mc; ir += LFORTRAN_GEMM_MR) {            \
+                        NAME##_micro(kc, ap + (int64_t)ir*kc,                  \
+                            bp + (int64_t)jr*kc,                               \
+                            c + ic + ir + (int64_t)(jc + jr)*ldc, ldc,         \
+                            mc - ir < LFORTRAN_GEMM_MR ? mc - ir               \
+                                : LFORTRAN_GEMM_MR,                            \
+                            nc - jr < LFORTRAN_GEMM_NR ? nc - jr               \
+                                : LFORTRAN_GEMM_NR,                            \
+                            pc == 0);                                          \
+                    }                                                          \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+    free(ap);                                                                  \
+    free(bp);                                                                  \
+}
+
+LFORTRAN_DEFINE_GEMM(_lfortran_sgemm, float)
+LFORTRAN_DEFINE_GEMM(_lfortran_dgemm, double)
+
+// The complex kernels are blocked over k and m (an MC x KC block of A is
+// reused for all columns of C), without packing.
+#define LFORTRAN_DEFINE_ZGEMM(NAME, C, T)                                      \
+LFORTRAN_API void NAME(int32_t m, int32_t n, int32_t k, C *a, int32_t lda,     \
+        C *b, int32_t ldb, C *c, int32_t ldc)                                  \
+{                                                                              \
+    int32_t i, j, p, ic, pc;                                                   \
+    for (j = 0; j < n; j++) {                                                  \
+        C *c_j = c + (int64_t)j*ldc;                                           \
+        for (i = 0; i < m; i++) {                                              \
+            c_j[i].re = 0;                                                     \
+            c_j[i].im = 0;                                                     \
+        }                                                                      \
+    }                                                                          \
+    for (pc = 0; pc < k; pc += LFORTRAN_GEMM_KC) {                             \
+        int32_t kc = k - pc < LFORTRAN_GEMM_KC ? k - pc : LFORTRAN_GEMM_KC;    \
+        for (ic = 0; ic < m; ic += LFORTRAN_GEMM_MC) {                         \
+            int32_t mc = m - ic < LFORTRAN_GEMM_MC ? m - ic : LFORTRAN_GEMM_MC;\
+            for (j = 0; j < n; j++) {                                          \
+                C *c_j = c + ic + (int64_t)j*ldc;                              \
+                for (p = pc; p < pc + kc; p++) {                               \
+                    const C *a_p = a + ic + (int64_t)p*lda;                    \
+                    T b_re = b[p + (int64_t)j*ldb].re;                         \
+                    T b_im = b[p + (int64_t)j*ldb].im;                         \
+                    for (i = 0; i < mc; i++) {                                 \
+                        T a_re = a_p[i].re, a_im = a_p[i].im;                  \
+                        c_j[i].re += a_re * b_re - a_im * b_im;                \
+                        c_j[i].im += a_re * b_im + a_im * b_re;                \
+                    }                                                          \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+    }                                                                          \
+}
+
+LFORTRAN_DEFINE_ZGEMM(_lfortran_cgemm, struct _lfortran_complex_32, float)
+LFORTRAN_DEFINE_ZGEMM(_lfortran_zgemm, struct _lfortran_complex_64, double)
+
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT DEFAULT
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#elif defined(_MSC_VER)
+#pragma fp_contract (on)
+#endif
+
+// Dot products of contiguous vectors with eight partial sums. The order of
+// the additions differs from a sequential loop, so these are only used with
+// --fast.
+#define LFORTRAN_DEFINE_DOT(NAME, T)                                           \
+LFORTRAN_API T NAME(int32_t n, T *x, T *y)                                     \
+{                                                                              \
+    T acc[8] = {0};                                                            \
+    int32_t i, j;                                                              \
+    for (i = 0; i + 8 <= n; i += 8) {                                          \
+        for (j = 0; j < 8; j++) acc[j] += x[i + j] * y[i + j];                 \
+    }                                                                          \
+    for (; i < n; i++) acc[0] += x[i] * y[i];                                  \
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3]))                             \
+        + ((acc[4] + acc[5]) + (acc[6] + acc[7]));                             \
+}
+
+LFORTRAN_DEFINE_DOT(_lfortran_sdot, float)
+LFORTRAN_DEFINE_DOT(_lfortran_ddot, double)
+
 LFORTRAN_API void _lfortran_random_number(int n, double *v)
 {
     int i;
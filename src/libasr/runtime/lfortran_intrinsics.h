@@ -66,6 +66,20 @@ typedef double _Complex double_complex_t;
 #endif
 
 LFORTRAN_API double _lfortran_sum(int n, double *v);
+LFORTRAN_API void _lfortran_sgemm(int32_t m, int32_t n, int32_t k, float *a,
+        int32_t lda, float *b, int32_t ldb, float *c, int32_t ldc);
+LFORTRAN_API void _lfortran_dgemm(int32_t m, int32_t n, int32_t k, double *a,
+        int32_t lda, double *b, int32_t ldb, double *c, int32_t ldc);
+LFORTRAN_API void _lfortran_cgemm(int32_t m, int32_t n, int32_t k,
+        struct _lfortran_complex_32 *a, int32_t lda,
+        struct _lfortran_complex_32 *b, int32_t ldb,
+        struct _lfortran_complex_32 *c, int32_t ldc);
+LFORTRAN_API void _lfortran_zgemm(int32_t m, int32_t n, int32_t k,
+        struct _lfortran_complex_64 *a, int32_t lda,
+        struct _lfortran_complex_64 *b, int32_t ldb,
+        struct _lfortran_complex_64 *c, int32_t ldc);
+LFORTRAN_API float _lfortran_sdot(int32_t n, float *x, float *y);
+LFORTRAN_API double _lfortran_ddot(int32_t n, double *x, double *y);
 LFORTRAN_API void _lfortran_random_number(int n, double *v);
 LFORTRAN_API void _lfortran_init_random_clock();
 LFORTRAN_API int _lfortran_init_random_seed(unsigned seed);
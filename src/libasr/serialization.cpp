@@ -1,4 +1,6 @@
 #include <string>
+#include <map>
+#include <memory>
 
 #include <libasr/config.h>
 #include <libasr/serialization.h>
@@ -25,6 +27,10 @@ class ASRSerializationVisitor :
         public ASR::SerializationBaseVisitor<ASRSerializationVisitor>
 {
 public:
+    // If set, the positions of the module level symbols are recorded here
+    std::vector<SymbolIndexEntry> *index = nullptr;
+    bool in_module_symbol = false;
+
     void write_bool(bool b) {
         if (b) {
             write_int8(1);
@@ -38,6 +44,35 @@ public:
         write_int8(x.type);
         write_string(symbol_name(&x));
     }
+
+    void write_symtab_entry(const std::string &name, const ASR::symbol_t &x) {
+        write_string(name);
+        SymbolTable *symtab = ASRUtils::symbol_symtab(&x);
+        if (index == nullptr) {
+            this->visit_symbol(x);
+        } else if (in_module_symbol) {
+            if (symtab) index->back().symtab_ids.push_back(symtab->counter);
+            this->visit_symbol(x);
+        } else if (is_module_level(x)) {
+            SymbolIndexEntry entry;
+            entry.name = name;
+            entry.start = size();
+            if (symtab) entry.symtab_ids.push_back(symtab->counter);
+            index->push_back(entry);
+            in_module_symbol = true;
+            this->visit_symbol(x);
+            in_module_symbol = false;
+            index->back().end = size();
+        } else {
+            this->visit_symbol(x);
+        }
+    }
+
+    static bool is_module_level(const ASR::symbol_t &x) {
+        ASR::asr_t *owner = symbol_parent_symtab(&x)->asr_owner;
+        return owner && ASR::is_a<ASR::symbol_t>(*owner)
+            && ASR::is_a<ASR::Module_t>(*ASR::down_cast<ASR::symbol_t>(owner));
+    }
 };
 
 std::string serialize(const ASR::asr_t &asr) {
@@ -51,6 +86,112 @@ std::string serialize(const ASR::TranslationUnit_t &unit) {
     return serialize((ASR::asr_t&)(unit));
 }
 
+std::string serialize(const ASR::TranslationUnit_t &unit,
+        std::vector<SymbolIndexEntry> &index) {
+    ASRSerializationVisitor v;
+    v.index = &index;
+    v.write_int8(unit.base.type);
+    v.visit_asr((ASR::asr_t&)(unit));
+    return v.get_str();
+}
+
+// Hashes the ASR as it would be serialized, except for the symbol table
+// counters and, without `lm`, the locations. Symbols are identified by their
+// path from the global scope instead of by the counter of their symbol table.
+class ASRHashVisitor :
+        public ASR::SerializationBaseVisitor<ASRHashVisitor>
+{
+private:
+    uint64_t hash = hash_fnv1a("");
+    std::string buffer;
+    const LocationManager *lm;
+
+    void flush() {
+        hash = hash_fnv1a(buffer, hash);
+        buffer.clear();
+    }
+
+public:
+    ASRHashVisitor(const LocationManager *lm) : lm{lm} {}
+
+    uint64_t get_hash() {
+        flush();
+        return hash;
+    }
+
+    void write_int8(uint8_t i) {
+        buffer.push_back(i);
+    }
+
+    void write_int64(uint64_t i) {
+        buffer.append((const char*)&i, sizeof(i));
+    }
+
+    void write_bool(bool b) {
+        write_int8(b ? 1 : 0);
+    }
+
+    void write_float64(double d) {
+        buffer.append((const char*)&d, sizeof(d));
+    }
+
+    void write_string(const std::string &t) {
+        write_int64(t.size());
+        buffer.append(t);
+        if (buffer.size() > 64*1024) flush();
+    }
+
+    void write_void(void *p, int64_t n_data) {
+        buffer.append((const char*)p, n_data);
+        if (buffer.size() > 64*1024) flush();
+    }
+
+    // The location in the original source, as the diagnostics and the debug
+    // information show it
+    void write_location(const Location &loc) {
+        if (!lm) return;
+        uint32_t line, col;
+        std::string filename;
+        lm->pos_to_linecol(lm->output_to_input_pos(loc.first, false),
+            line, col, filename);
+        write_int64(line);
+        write_int64(col);
+        write_string(filename);
+        lm->pos_to_linecol(lm->output_to_input_pos(loc.last, true),
+            line, col, filename);
+        write_int64(line);
+        write_int64(col);
+    }
+
+    void write_symtab_id(const SymbolTable &/*symtab*/) {}
+
+    void write_symbol(const ASR::symbol_t &x) {
+        write_int8(x.type);
+        write_string(symbol_name(&x));
+        SymbolTable *symtab = symbol_parent_symtab(&x);
+        while (symtab->asr_owner
+                && ASR::is_a<ASR::symbol_t>(*symtab->asr_owner)) {
+            ASR::symbol_t *owner = ASR::down_cast<ASR::symbol_t>(
+                symtab->asr_owner);
+            write_string(symbol_name(owner));
+            symtab = symbol_parent_symtab(owner);
+        }
+        write_string("");
+    }
+
+    void write_symtab_entry(const std::string &name, const ASR::symbol_t &x) {
+        write_string(name);
+        this->visit_symbol(x);
+    }
+};
+
+uint64_t structural_hash(const ASR::asr_t &asr, const LocationManager *lm) {
+    ASRHashVisitor v(lm);
+    v.write_int8(asr.type);
+    v.visit_asr(asr);
+    return v.get_hash();
+}
+
 class ASRDeserializationVisitor :
 #ifdef WITH_LFORTRAN_BINARY_MODFILES
         public BinaryReader,
@@ -69,12 +210,39 @@ public:
 #endif
             DeserializationBaseVisitor(al, load_symtab_id, offset) {}
 
+    // Reads from `data` without copying it. If `in_place` is true, `data`
+    // outlives the ASR and strings and constant arrays point into it.
+    ASRDeserializationVisitor(Allocator &al, const char *data, size_t size,
+        bool load_symtab_id, uint32_t offset, bool in_place) :
+#ifdef WITH_LFORTRAN_BINARY_MODFILES
+            BinaryReader(data, size),
+#else
+            TextReader(data, size),
+#endif
+            DeserializationBaseVisitor(al, load_symtab_id, offset),
+            in_place{in_place} {}
+
+    bool in_place = false;
+
+    // Module level symbols that are not deserialized (start -> end position)
+    std::map<uint64_t, uint64_t> skipped_symbols;
+    // The symbol table of a lazily loaded module and the module level
+    // symbols that contain a given symbol table
+    SymbolTable *lazy_symtab = nullptr;
+    std::map<uint64_t, std::string> symtab_owner;
+
     bool read_bool() {
         uint8_t b = read_int8();
         return (b == 1);
     }
 
     char* read_cstring() {
+#ifdef WITH_LFORTRAN_BINARY_MODFILES
+        if (in_place) {
+            size_t n;
+            return const_cast<char*>(read_string_in_place(n));
+        }
+#endif
         std::string s = read_string();
         LCompilers::Str cs;
         cs.from_str_view(s);
@@ -82,6 +250,17 @@ public:
         return p;
     }
 
+    void* read_void(int64_t n_data) {
+#ifdef WITH_LFORTRAN_BINARY_MODFILES
+        if (in_place) {
+            return const_cast<void*>(read_void_in_place(n_data));
+        }
+        return BinaryReader::read_void(n_data);
+#else
+        return TextReader::read_void(n_data);
+#endif
+    }
+
 #define READ_SYMBOL_CASE(x)                                \
     case (ASR::symbolType::x) : {                          \
         s = (ASR::symbol_t*)al.make_new<ASR::x##_t>();     \
@@ -104,6 +283,14 @@ public:
         // it in write_symbol() above
         uint64_t symbol_type = read_int8();
         std::string symbol_name  = read_string();
+        if (lazy_symtab && id_symtab_map.find(symtab_id) == id_symtab_map.end()) {
+            // The symbol table is inside of a module level symbol that was
+            // not loaded yet
+            auto owner = symtab_owner.find(symtab_id);
+            if (owner != symtab_owner.end()) {
+                lazy_symtab->get_symbol(owner->second);
+            }
+        }
         LCOMPILERS_ASSERT(id_symtab_map.find(symtab_id) != id_symtab_map.end());
         SymbolTable *symtab = id_symtab_map[symtab_id];
         if (symtab->get_symbol(symbol_name) == nullptr) {
@@ -130,6 +317,19 @@ public:
         return sym;
     }
 
+    void read_symtab_entry(SymbolTable &symtab) {
+        std::string name = read_string();
+        if (!skipped_symbols.empty()) {
+            auto skipped = skipped_symbols.find(get_pos());
+            if (skipped != skipped_symbols.end()) {
+                set_pos(skipped->second);
+                return;
+            }
+        }
+        ASR::symbol_t *sym = ASR::down_cast<ASR::symbol_t>(deserialize_symbol());
+        symtab_insert_symbol(symtab, name, sym);
+    }
+
     void symtab_insert_symbol(SymbolTable &symtab, const std::string &name,
         ASR::symbol_t *sym) {
         if (symtab.get_symbol(name) == nullptr) {
@@ -160,10 +360,16 @@ class FixParentSymtabVisitor : public BaseWalkVisitor<FixParentSymtabVisitor>
 private:
     SymbolTable *current_symtab;
 public:
+    // Fixes the symbol tables inside `sym`, a symbol of `symtab`
+    void fix_symbol(const symbol_t &sym, SymbolTable *symtab) {
+        current_symtab = symtab;
+        this->visit_symbol(sym);
+    }
+
     void visit_TranslationUnit(const TranslationUnit_t &x) {
         current_symtab = x.m_symtab;
         x.m_symtab->asr_owner = (asr_t*)&x;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
     }
@@ -173,7 +379,7 @@ public:
         current_symtab = x.m_symtab;
         x.m_symtab->parent = parent_symtab;
         x.m_symtab->asr_owner = (asr_t*)&x;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -184,7 +390,7 @@ public:
         current_symtab = x.m_symtab;
         x.m_symtab->parent = parent_symtab;
         x.m_symtab->asr_owner = (asr_t*)&x;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -195,7 +401,7 @@ public:
         current_symtab = x.m_symtab;
         x.m_symtab->parent = parent_symtab;
         x.m_symtab->asr_owner = (asr_t*)&x;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -206,7 +412,7 @@ public:
         current_symtab = x.m_symtab;
         x.m_symtab->parent = parent_symtab;
         x.m_symtab->asr_owner = (asr_t*)&x;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -217,7 +423,7 @@ public:
         current_symtab = x.m_symtab;
         x.m_symtab->parent = parent_symtab;
         x.m_symtab->asr_owner = (asr_t*)&x;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -228,7 +434,7 @@ public:
         current_symtab = x.m_symtab;
         x.m_symtab->parent = parent_symtab;
         x.m_symtab->asr_owner = (asr_t*)&x;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -239,7 +445,7 @@ public:
         current_symtab = x.m_symtab;
         x.m_symtab->parent = parent_symtab;
         x.m_symtab->asr_owner = (asr_t*)&x;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -250,7 +456,7 @@ public:
         current_symtab = x.m_symtab;
         x.m_symtab->parent = parent_symtab;
         x.m_symtab->asr_owner = (asr_t*)&x;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -261,7 +467,7 @@ public:
         current_symtab = x.m_symtab;
         x.m_symtab->parent = parent_symtab;
         x.m_symtab->asr_owner = (asr_t*)&x;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
         current_symtab = parent_symtab;
@@ -283,9 +489,16 @@ public:
     FixExternalSymbolsVisitor(SymbolTable &symtab) : external_symtab{&symtab},
     attempt{0}, fixed_external_syms{true} {}
 
+    // Fixes the external symbols inside `sym`, a symbol of `symtab`
+    void fix_symbol(const symbol_t &sym, SymbolTable *symtab) {
+        global_symtab = symtab->get_global_scope();
+        current_scope = symtab;
+        this->visit_symbol(sym);
+    }
+
     void visit_TranslationUnit(const TranslationUnit_t &x) {
         global_symtab = x.m_symtab;
-        for (auto &a : x.m_symtab->get_scope()) {
+        for (auto &a : x.m_symtab->get_loaded_scope()) {
             this->visit_symbol(*a.second);
         }
     }
@@ -411,6 +624,69 @@ void fix_external_symbols(ASR::TranslationUnit_t &unit,
     }
 }
 
+// Deserializes the module level symbols of a module on demand
+class LazyModuleLoader : public LazySymbolLoader
+{
+public:
+    ASRDeserializationVisitor v;
+    SymbolTable *symtab = nullptr;
+    // Symbols not loaded yet
+    std::map<std::string, uint64_t> symbol_start;
+
+    LazyModuleLoader(Allocator &al, const char *data, size_t size,
+        const std::vector<SymbolIndexEntry> &index, bool load_symtab_id,
+        uint32_t offset) : v(al, data, size, load_symtab_id, offset, true) {
+        for (auto &entry : index) {
+            symbol_start[entry.name] = entry.start;
+            v.skipped_symbols[entry.start] = entry.end;
+            for (auto id : entry.symtab_ids) {
+                v.symtab_owner[id] = entry.name;
+            }
+        }
+    }
+
+    ASR::symbol_t* load_symbol(const std::string &name) override {
+        auto it = symbol_start.find(name);
+        if (it == symbol_start.end()) return nullptr;
+        uint64_t start = it->second;
+        // Symbols that reference `name` while it is being loaded get an
+        // empty symbol, which is filled in by `symtab_insert_symbol`
+        symbol_start.erase(it);
+        size_t pos = v.get_pos();
+        v.set_pos(start);
+        ASR::symbol_t *sym = ASR::down_cast<ASR::symbol_t>(v.deserialize_symbol());
+        v.set_pos(pos);
+        v.symtab_insert_symbol(*symtab, name, sym);
+        sym = symtab->get_symbol(name);
+
+        ASR::FixParentSymtabVisitor p;
+        p.fix_symbol(*sym, symtab);
+        // External symbols to modules that are not loaded yet are fixed by
+        // `fix_external_symbols` in `load_module`
+        ASR::FixExternalSymbolsVisitor e(*symtab->get_global_scope());
+        e.fix_symbol(*sym, symtab);
+        return sym;
+    }
+
+    void load_all() override {
+        while (!symbol_start.empty()) {
+            load_symbol(symbol_start.begin()->first);
+        }
+    }
+};
+
+static void verify_deserialized_asr(ASR::TranslationUnit_t &tu) {
+#if defined(WITH_LFORTRAN_ASSERT)
+    diag::Diagnostics diagnostics;
+    if (!asr_verify(tu, false, diagnostics)) {
+        std::cerr << diagnostics.render2();
+        throw LCompilersException("Verify failed");
+    };
+#else
+    if ((bool&)tu) { } // Suppress unused warning in Release mode
+#endif
+}
+
 ASR::asr_t* deserialize_asr(Allocator &al, const std::string &s,
         bool load_symtab_id, SymbolTable & /*external_symtab*/, uint32_t offset) {
     return deserialize_asr(al, s, load_symtab_id, offset);
@@ -418,7 +694,14 @@ ASR::asr_t* deserialize_asr(Allocator &al, const std::string &s,
 
 ASR::asr_t* deserialize_asr(Allocator &al, const std::string &s,
         bool load_symtab_id, uint32_t offset) {
-    ASRDeserializationVisitor v(al, s, load_symtab_id, offset);
+    return deserialize_asr(al, s.data(), s.size(), load_symtab_id, offset,
+        false);
+}
+
+ASR::asr_t* deserialize_asr(Allocator &al, const char *data, size_t size,
+        bool load_symtab_id, uint32_t offset, bool in_place) {
+    ASRDeserializationVisitor v(al, data, size, load_symtab_id, offset,
+        in_place);
     ASR::asr_t *node = v.deserialize_node();
     ASR::TranslationUnit_t *tu = ASR::down_cast2<ASR::TranslationUnit_t>(node);
 
@@ -427,13 +710,36 @@ ASR::asr_t* deserialize_asr(Allocator &al, const std::string &s,
     ASR::FixParentSymtabVisitor p;
     p.visit_TranslationUnit(*tu);
 
-#if defined(WITH_LFORTRAN_ASSERT)
-    diag::Diagnostics diagnostics;
-    if (!asr_verify(*tu, false, diagnostics)) {
-        std::cerr << diagnostics.render2();
-        throw LCompilersException("Verify failed");
-    };
- #endif
+    verify_deserialized_asr(*tu);
+
+    return node;
+}
+
+ASR::asr_t* deserialize_asr_lazy(Allocator &al, const char *data, size_t size,
+        const std::vector<SymbolIndexEntry> &index,
+        bool load_symtab_id, uint32_t offset) {
+    // The loader lives as long as the module
+    LazyModuleLoader *loader = al.keep(std::make_shared<LazyModuleLoader>(
+        al, data, size, index, load_symtab_id, offset));
+    ASR::asr_t *node = loader->v.deserialize_node();
+    ASR::TranslationUnit_t *tu = ASR::down_cast2<ASR::TranslationUnit_t>(node);
+    loader->v.skipped_symbols.clear();
+
+    ASR::FixParentSymtabVisitor p;
+    p.visit_TranslationUnit(*tu);
+
+    for (auto &a : tu->m_symtab->get_scope()) {
+        if (ASR::is_a<ASR::Module_t>(*a.second)) {
+            // Modfiles contain exactly one module
+            LCOMPILERS_ASSERT(loader->symtab == nullptr);
+            loader->symtab = ASR::down_cast<ASR::Module_t>(a.second)->m_symtab;
+        }
+    }
+    LCOMPILERS_ASSERT(loader->symtab);
+    loader->symtab->lazy_loader = loader;
+    loader->v.lazy_symtab = loader->symtab;
+
+    verify_deserialized_asr(*tu);
 
     return node;
 }
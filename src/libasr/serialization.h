@@ -1,16 +1,53 @@
 #ifndef LIBASR_SERIALIZATION_H
 #define LIBASR_SERIALIZATION_H
 
+#include <vector>
+
 #include <libasr/asr.h>
 
 namespace LCompilers {
 
+    // Position of a module level symbol in the serialized ASR, so that it can
+    // be deserialized on its own
+    struct SymbolIndexEntry {
+        std::string name;
+        // The serialized symbol is the range [start, end)
+        uint64_t start;
+        uint64_t end;
+        // Counters of the symbol tables inside the symbol
+        std::vector<uint64_t> symtab_ids;
+    };
+
     std::string serialize(const ASR::asr_t &asr);
     std::string serialize(const ASR::TranslationUnit_t &unit);
+    // Also returns the positions of the module level symbols in `index`
+    std::string serialize(const ASR::TranslationUnit_t &unit,
+            std::vector<SymbolIndexEntry> &index);
+    // Hash of the ASR that ignores the symbol table counters. Without `lm`
+    // the locations are ignored too: the hash only changes when the code
+    // does, not when comments, formatting or code outside of `asr` are
+    // edited. With `lm` the file, line and column of every location are
+    // hashed, so edits that move code to other lines change it. It can be
+    // used for a single Function_t as well as for a whole module.
+    uint64_t structural_hash(const ASR::asr_t &asr,
+        const LocationManager *lm=nullptr);
     ASR::asr_t* deserialize_asr(Allocator &al, const std::string &s,
             bool load_symtab_id, SymbolTable &symtab, uint32_t offset);
     ASR::asr_t* deserialize_asr(Allocator &al, const std::string &s,
             bool load_symtab_id, uint32_t offset);
+    // Deserializes `size` bytes at `data`. If `in_place` is true, `data` must
+    // stay valid as long as the ASR is used: identifiers and constant arrays
+    // point into it instead of being copied.
+    ASR::asr_t* deserialize_asr(Allocator &al, const char *data, size_t size,
+            bool load_symtab_id, uint32_t offset, bool in_place);
+    // Deserializes the module in `data` without its module level symbols.
+    // The symbols from `index` are deserialized on demand when they are
+    // looked up in the module's symbol table (together with the symbols they
+    // reference), see `SymbolTable::lazy_loader`. `data` must stay valid as
+    // long as the ASR is used, as for `in_place` above.
+    ASR::asr_t* deserialize_asr_lazy(Allocator &al, const char *data,
+            size_t size, const std::vector<SymbolIndexEntry> &index,
+            bool load_symtab_id, uint32_t offset);
 
     void fix_external_symbols(ASR::TranslationUnit_t &unit,
             SymbolTable &external_symtab);
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include <libasr/string_interner.h>
+
+namespace LCompilers {
+
+namespace {
+
+// The table is split into shards by hash, each with its own lock, so that
+// threads parsing different parts of a file rarely wait for each other
+const size_t n_shards = 32;
+// The blocks of a shard double in size up to `max_block_size`
+const size_t min_block_size = 1024;
+const size_t max_block_size = 64*1024;
+
+struct Shard {
+    std::mutex mutex;
+    std::unordered_set<std::string_view> strings;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char *cur = nullptr;
+    size_t left = 0;
+    size_t bytes = 0;
+
+    // Copies `s` into the current block, starting a new block if needed
+    char *store(std::string_view s) {
+        size_t n = s.size() + 1;
+        if (n > left) {
+            size_t size = std::clamp(bytes, min_block_size, max_block_size);
+            size = std::max(n, size);
+            blocks.push_back(std::unique_ptr<char[]>(new char[size]));
+            cur = blocks.back().get();
+            left = size;
+            bytes += size;
+        }
+        char *p = cur;
+        std::memcpy(p, s.data(), s.size());
+        p[s.size()] = '\0';
+        cur += n;
+        left -= n;
+        return p;
+    }
+};
+
+Shard &shard(size_t hash) {
+    // Constructed on first use, never destroyed: interned strings may be used
+    // by destructors of other static objects
+    static Shard *shards = new Shard[n_shards];
+    return shards[hash % n_shards];
+}
+
+} // namespace
+
+char *intern(std::string_view s) {
+    size_t hash = std::hash<std::string_view>()(s);
+    Shard &sh = shard(hash);
+    std::lock_guard<std::mutex> lock(sh.mutex);
+    auto it = sh.strings.find(s);
+    if (it != sh.strings.end()) return const_cast<char*>(it->data());
+    char *p = sh.store(s);
+    sh.strings.insert(std::string_view(p, s.size()));
+    return p;
+}
+
+void clear_interned() {
+    for (size_t i = 0; i < n_shards; i++) {
+        Shard &sh = shard(i);
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        std::unordered_set<std::string_view>().swap(sh.strings);
+        std::vector<std::unique_ptr<char[]>>().swap(sh.blocks);
+        sh.cur = nullptr;
+        sh.left = 0;
+        sh.bytes = 0;
+    }
+}
+
+size_t interned_count() {
+    size_t n = 0;
+    for (size_t i = 0; i < n_shards; i++) {
+        Shard &sh = shard(i);
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        n += sh.strings.size();
+    }
+    return n;
+}
+
+size_t interned_bytes() {
+    size_t n = 0;
+    for (size_t i = 0; i < n_shards; i++) {
+        Shard &sh = shard(i);
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        n += sh.bytes;
+    }
+    return n;
+}
+
+} // namespace LCompilers
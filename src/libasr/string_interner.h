@@ -0,0 +1,42 @@
+#ifndef LFORTRAN_STRING_INTERNER_H
+#define LFORTRAN_STRING_INTERNER_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace LCompilers {
+
+/* Process-wide table of identifiers.
+ *
+ * `intern(s)` returns the same pointer for equal strings, so the name of a
+ * variable that appears in thousands of places of the AST is stored once and
+ * names can be compared by pointer. The strings are kept in large blocks that
+ * are shared between threads, so they must not be modified.
+ *
+ * The table grows with the distinct identifiers of all the sources parsed by
+ * the process. That is bounded for a compilation, and the compile server
+ * compiles every request in a forked worker. A process that parses in process
+ * for every request (the language server) calls `clear_interned()` between
+ * the requests.
+ */
+
+// Returns the interned, null terminated copy of `s`. Thread safe.
+char *intern(std::string_view s);
+
+// Returns true if `a` and `b` are the same identifier. Pointer comparison for
+// interned strings, string comparison otherwise.
+inline bool intern_eq(const char *a, const char *b) {
+    return a == b || std::string_view(a) == std::string_view(b);
+}
+
+// Frees all interned strings. Only allowed if no AST (or anything else that
+// refers to interned strings) is alive and no other thread interns strings.
+void clear_interned();
+
+// Number of distinct strings and bytes used by the interned strings
+size_t interned_count();
+size_t interned_bytes();
+
+} // namespace LCompilers
+
+#endif // LFORTRAN_STRING_INTERNER_H
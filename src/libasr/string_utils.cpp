@@ -195,6 +195,29 @@ std::string str_escape_c(const std::string &s) {
     return o.str();
 }
 
+std::string str_escape_json(const std::string &s) {
+    std::ostringstream o;
+    for (auto c = s.cbegin(); c != s.cend(); c++) {
+        switch (*c) {
+            case '"': o << "\\\""; break;
+            case '\\': o << "\\\\"; break;
+            case '\b': o << "\\b"; break;
+            case '\f': o << "\\f"; break;
+            case '\n': o << "\\n"; break;
+            case '\r': o << "\\r"; break;
+            case '\t': o << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    o << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << static_cast<int>(*c) << std::dec;
+                } else {
+                    o << *c;
+                }
+        }
+    }
+    return o.str();
+}
+
 char* str_unescape_c(Allocator &al, LCompilers::Str &s) {
     std::string x = "";
     size_t idx = 0;
@@ -283,4 +306,20 @@ void rtrim(std::string& str) {
     str.erase(std::find_if_not(str.rbegin(), str.rend(), ::isspace).base(), str.end());
 }
 
+uint64_t hash_fnv1a(const std::string &s, uint64_t hash)
+{
+    for (unsigned char c : s) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+std::string hash_to_hex(uint64_t hash)
+{
+    std::stringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return ss.str();
+}
+
 } // namespace LCompilers
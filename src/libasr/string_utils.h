@@ -41,6 +41,8 @@ std::string join_paths(const std::vector<std::string> &paths);
 // Escapes special characters from the given string
 // using C style escaping
 std::string str_escape_c(const std::string &s);
+// Escapes the given string for use in a JSON string literal
+std::string str_escape_json(const std::string &s);
 char* str_unescape_c(Allocator &al, LCompilers::Str &s);
 
 // Escapes double quote characters from the given string
@@ -51,6 +53,13 @@ char* str_unescape_fortran(Allocator &al, LCompilers::Str &s, char ch);
 bool str_compare(const unsigned char *pos, std::string s);
 void rtrim(std::string& str);
 
+// 64-bit FNV-1a hash of the given bytes, stable across runs and platforms.
+// Pass the previous result as `hash` to hash several strings together.
+uint64_t hash_fnv1a(const std::string &s,
+    uint64_t hash=0xcbf29ce484222325ULL);
+// Hash as a fixed width hexadecimal string
+std::string hash_to_hex(uint64_t hash);
+
 } // namespace LCompilers
 
 #endif // LFORTRAN_STRING_UTILS_H
@@ -0,0 +1,97 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include <libasr/trace.h>
+#include <libasr/string_utils.h>
+
+namespace LCompilers::trace {
+
+namespace {
+
+std::FILE *trace_file = nullptr;
+std::atomic<bool> trace_enabled{false};
+std::mutex trace_mutex;
+std::atomic<int> n_threads{0};
+
+thread_local std::string current_file;
+thread_local int thread_id = -1;
+
+int get_thread_id() {
+    if (thread_id == -1) thread_id = n_threads++;
+    return thread_id;
+}
+
+void write_event(const std::string &name, char phase) {
+    if (!trace_enabled) return;
+    // steady_clock is system wide, so that the events of forked processes
+    // share the time axis
+    int64_t ts = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::stringstream event;
+    event << "{\"name\": \"" << str_escape_json(name) << "\", "
+        << "\"cat\": \"lfortran\", \"ph\": \"" << phase << "\", "
+        << "\"ts\": " << ts << ", "
+        << "\"pid\": " << getpid() << ", "
+        << "\"tid\": " << get_thread_id() << ", "
+        << "\"args\": {\"file\": \"" << str_escape_json(current_file) << "\"}},\n";
+    std::string s = event.str();
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    if (!trace_file) return;
+    // The buffer is flushed after every event: it must be empty when the
+    // process forks, and processes must not interleave partial events
+    std::fwrite(s.data(), 1, s.size(), trace_file);
+    std::fflush(trace_file);
+}
+
+} // namespace
+
+bool open(const std::string &filename) {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    std::FILE *f = std::fopen(filename.c_str(), "w");
+    if (!f) return false;
+    std::fputs("[\n", f);
+    std::fclose(f);
+    // Append mode: every write goes to the current end of the file, also
+    // when several processes write to it
+    trace_file = std::fopen(filename.c_str(), "a");
+    if (!trace_file) return false;
+    trace_enabled = true;
+    return true;
+}
+
+void close() {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    trace_enabled = false;
+    if (trace_file) {
+        std::fclose(trace_file);
+        trace_file = nullptr;
+    }
+}
+
+bool enabled() {
+    return trace_enabled;
+}
+
+void set_file(const std::string &filename) {
+    current_file = filename;
+}
+
+void begin(const std::string &name) {
+    write_event(name, 'B');
+}
+
+void end(const std::string &name) {
+    write_event(name, 'E');
+}
+
+} // namespace LCompilers::trace
@@ -0,0 +1,58 @@
+#ifndef LFORTRAN_TRACE_H
+#define LFORTRAN_TRACE_H
+
+#include <string>
+
+namespace LCompilers {
+
+/* Timeline of the compiler phases in the Chrome trace event format, which
+ * can be loaded in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * The trace file is a JSON array without the closing `]` (allowed by the
+ * format), so that every event is appended by a single write. Worker
+ * processes forked by `-j N` or by the compile server append to the same
+ * file; each event records the process and thread that produced it and the
+ * source file being compiled.
+ */
+namespace trace {
+
+// Creates (truncates) the trace file and enables tracing in this process
+// and in the processes forked from it. Returns false if the file cannot be
+// opened.
+bool open(const std::string &filename);
+
+// Stops tracing and closes the file
+void close();
+
+bool enabled();
+
+// Sets the source file that the events of the current thread are tagged
+// with
+void set_file(const std::string &filename);
+
+// Begin ("B") and end ("E") events of a phase. Every `begin` must be
+// matched by an `end` with the same name on the same thread.
+void begin(const std::string &name);
+void end(const std::string &name);
+
+// Emits `begin` in the constructor and `end` in the destructor if tracing
+// is enabled
+class Scope {
+    std::string name;
+    bool active;
+public:
+    Scope(const std::string &name) : name{name}, active{enabled()} {
+        if (active) trace::begin(name);
+    }
+    ~Scope() {
+        if (active) trace::end(name);
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+};
+
+} // namespace trace
+
+} // namespace LCompilers
+
+#endif // LFORTRAN_TRACE_H
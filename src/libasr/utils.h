@@ -24,6 +24,20 @@ std::string get_unique_ID();
 int visualize_json(std::string &astr_data_json, LCompilers::Platform os);
 std::string generate_visualize_html(std::string &astr_data_json);
 
+// Memory usage of the compiler after a phase, see `--memory-report`
+struct MemoryUsage {
+    std::string file;
+    std::string phase;
+    int64_t peak_rss = 0; // Peak resident set size of the process (bytes)
+    int64_t current_rss = 0; // Current resident set size (bytes), 0 if unknown
+    int64_t allocator_bytes = 0; // Bytes allocated in the Allocator
+};
+
+// Returns the peak / current resident set size of this process in bytes,
+// or 0 if it is not available on this platform
+int64_t get_peak_rss();
+int64_t get_current_rss();
+
 struct PassOptions {
     std::filesystem::path mod_files_dir;
     std::vector<std::filesystem::path> include_dirs;
@@ -36,6 +50,8 @@ struct PassOptions {
     bool always_run = false; // for unused_functions pass
     bool inline_external_symbol_calls = true; // for inline_function_calls pass
     int64_t unroll_factor = 32; // for loop_unroll pass
+    int64_t tile_cache_size = 32*1024; // in bytes, for loop_tile pass
+    std::string blas = ""; // BLAS library for large products, for matmul_kernel pass
     bool fast = false; // is fast flag enabled.
     bool verbose = false; // For developer debugging
     bool dump_all_passes = false; // For developer debugging
@@ -63,9 +79,21 @@ struct PassOptions {
     bool openmp = false;
     bool enable_gpu_offloading = false;
     bool time_report = false;
+    bool lazy_modfiles = false; // Load the symbols of modfiles on demand
+    // Apply the procedure local passes on this many threads
+    int pass_threads = 1;
     std::vector<std::string> vector_of_time_report;
+    bool memory_report = false;
+    std::vector<MemoryUsage> vector_of_memory_report;
 };
 
+// Appends the memory usage after `phase` to `vector_of_memory_report` if
+// `--memory-report` is enabled
+void record_memory_usage(PassOptions &pass_options, const std::string &phase,
+    Allocator &al);
+std::string memory_report_to_text(const std::vector<MemoryUsage> &report);
+std::string memory_report_to_json(const std::vector<MemoryUsage> &report);
+
 struct CompilerOptions {
     std::vector<std::string> runtime_linker_paths;
 
@@ -77,6 +105,8 @@ struct CompilerOptions {
     bool c_preprocessor = false;
     std::vector<std::string> c_preprocessor_defines;
     bool prescan = true;
+    // Parse the top-level units of a free-form source on this many threads
+    int parse_threads = 1;
     bool disable_main = false;
     bool symtab_only = false;
     bool show_stacktrace = false;
@@ -122,6 +152,9 @@ struct CompilerOptions {
     bool stack_arrays = false;
     bool wasm_html = false;
     bool time_report = false;
+    bool memory_report = false;
+    std::string memory_report_json = ""; // write the memory report as JSON
+    std::string cache_dir = ""; // compilation cache, disabled if empty
     std::string emcc_embed;
     std::vector<std::string> import_paths;
     Platform platform;
@@ -1,6 +1,10 @@
 #ifdef _WIN32
 #define NOMINMAX
 #include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
 #endif
 
 #include <iostream>
@@ -8,6 +12,7 @@
 #include <filesystem>
 #include <random>
 #include <sstream>
+#include <iomanip>
 
 #include <libasr/exception.h>
 #include <libasr/utils.h>
@@ -66,6 +71,98 @@ bool present(char** const v, size_t n, const std::string name) {
     return false;
 }
 
+int64_t get_peak_rss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return pmc.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return usage.ru_maxrss; // bytes
+#else
+    return (int64_t)usage.ru_maxrss * 1024; // kilobytes
+#endif
+#endif
+}
+
+int64_t get_current_rss() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return pmc.WorkingSetSize;
+    }
+    return 0;
+#elif defined(__linux__)
+    // The second field of /proc/self/statm is the resident set size in pages
+    std::ifstream statm("/proc/self/statm");
+    int64_t size = 0, resident = 0;
+    if (!(statm >> size >> resident)) return 0;
+    return resident * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+
+void record_memory_usage(PassOptions &pass_options, const std::string &phase,
+        Allocator &al) {
+    if (!pass_options.memory_report) return;
+    MemoryUsage m;
+    m.phase = phase;
+    m.peak_rss = get_peak_rss();
+    m.current_rss = get_current_rss();
+    m.allocator_bytes = al.stats().bytes_allocated;
+    pass_options.vector_of_memory_report.push_back(m);
+}
+
+std::string memory_report_to_text(const std::vector<MemoryUsage> &report) {
+    auto mb = [](int64_t bytes) {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(1) << bytes / (1024. * 1024);
+        return ss.str();
+    };
+    std::stringstream out;
+    out << std::string(80, '-') << '\n';
+    out << std::left << std::setw(44) << "Component name"
+        << std::right << std::setw(12) << "Peak (MB)"
+        << std::setw(12) << "RSS (MB)"
+        << std::setw(12) << "Alloc (MB)" << '\n';
+    out << std::string(80, '-') << '\n';
+    std::string file;
+    for (auto &m : report) {
+        if (m.file != file) {
+            file = m.file;
+            out << file << ":\n";
+        }
+        out << std::left << std::setw(44) << m.phase
+            << std::right << std::setw(12) << mb(m.peak_rss)
+            << std::setw(12) << mb(m.current_rss)
+            << std::setw(12) << mb(m.allocator_bytes) << '\n';
+    }
+    out << std::string(80, '-') << '\n';
+    return out.str();
+}
+
+std::string memory_report_to_json(const std::vector<MemoryUsage> &report) {
+    std::stringstream out;
+    out << "[\n";
+    for (size_t i = 0; i < report.size(); i++) {
+        const MemoryUsage &m = report[i];
+        out << "  {\"file\": \"" << str_escape_json(m.file) << "\", "
+            << "\"phase\": \"" << str_escape_json(m.phase) << "\", "
+            << "\"peak_rss\": " << m.peak_rss << ", "
+            << "\"current_rss\": " << m.current_rss << ", "
+            << "\"allocator_bytes\": " << m.allocator_bytes << "}";
+        if (i + 1 < report.size()) out << ",";
+        out << "\n";
+    }
+    out << "]\n";
+    return out.str();
+}
+
 int visualize_json(std::string &astr_data_json, LCompilers::Platform os) {
     using namespace LCompilers;
     std::hash<std::string> hasher;